@@ -0,0 +1,88 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_IR_PARALLELPLAN
+#define STUFF_IR_PARALLELPLAN
+
+#include <operation/op.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Block;
+class Value;
+class MachineState;
+
+// Independent sub-computations of a Block, found by abstract simulation of its stack.
+// Every pure operation with a statically known stack effect produces a group: the contiguous
+// range of operations that computes one or more values without reading anything below them.
+// Groups that are consumed together (or left on the stack together) form a region, which can
+// be evaluated on forked machines in parallel and joined back onto the stack in order.
+// Calls and execs are resolved against the value store, so a plan is only valid for as long
+// as every name it resolved still holds the same value.
+class ParallelPlan {
+    public:
+        static constexpr size_t LOOP_WEIGHT = 100;
+
+        struct StackEffect {
+            size_t consumed;
+            size_t produced;
+            size_t cost;
+        };
+
+        struct Group {
+            size_t begin;
+            size_t end;
+            size_t cost;
+        };
+
+        struct Region {
+            size_t begin;
+            size_t end;
+            std::vector<Group> groups;
+        };
+
+        static std::shared_ptr<ParallelPlan> fromBlock(const Block&, MachineState&);
+
+        static std::optional<StackEffect> effectOf(std::shared_ptr<Operation>, MachineState&);
+
+        size_t size() const;
+        const Region& at(size_t) const;
+        std::optional<size_t> regionAt(size_t begin, size_t limit) const;
+
+        bool isCurrent(MachineState&) const;
+
+        Operation::Result execute(MachineState&, Block&, size_t) const;
+
+    private:
+        ParallelPlan(MachineState&);
+
+        class Analyzer;
+
+        Operation::Result run(MachineState&, Block&, size_t begin, size_t end) const;
+
+        void addRegion(const std::vector<Group>&, size_t threshold);
+
+        std::vector<Region> mRegions;
+        std::vector<size_t> mRegionAt;
+        std::vector<size_t> mNextRegion;
+        std::vector<std::pair<std::string, std::shared_ptr<Value>>> mDependencies;
+        size_t mThreshold;
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_IR_PIPELINEPLAN
+#define STUFF_IR_PIPELINEPLAN
+
+#include <operation/op.h>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class Block;
+class Value;
+class MachineState;
+
+// Chains of map and filter over constant callbacks, optionally ending in a reduce, found in a Block.
+// A pipeline runs every element through all of its stages in a single pass over the source, so no
+// intermediate container is ever built; only the final result is materialized.
+// Fusion is only attempted when it cannot be observed: the source must be a tuple or a range (whose
+// intermediate results are plain tuples), and every callback must be pure and consume exactly its
+// arguments. Otherwise, or on any failure, the stack is put back as it was and the original
+// operations run one by one, which reproduces the exact same result or error state.
+class PipelinePlan {
+    public:
+        struct Stage {
+            OperationType type;
+            std::shared_ptr<Value> callback;
+        };
+
+        struct Pipeline {
+            size_t begin;
+            size_t end;
+            std::vector<Stage> stages;
+            std::shared_ptr<Value> reducer;
+            std::shared_ptr<Value> initial;
+        };
+
+        static std::shared_ptr<PipelinePlan> fromBlock(const Block&);
+
+        size_t size() const;
+        const Pipeline& at(size_t) const;
+        std::optional<size_t> pipelineAt(size_t) const;
+
+        Operation::Result execute(MachineState&, Block&, size_t) const;
+
+    private:
+        PipelinePlan() = default;
+
+        bool fusible(MachineState&, const Pipeline&, const std::shared_ptr<Value>&) const;
+        Operation::Result deoptimize(MachineState&, Block&, const Pipeline&, size_t, const std::shared_ptr<Value>&) const;
+
+        std::vector<Pipeline> mPipelines;
+        std::vector<std::optional<size_t>> mPipelineAt;
+};
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_IR_REGISTERPROGRAM
+#define STUFF_IR_REGISTERPROGRAM
+
+#include <operation/op.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Block;
+class Value;
+class MachineState;
+
+// A Block translated into three-address form by abstract simulation of its stack.
+// Values that the stack interpreter would shuffle around (push, dup, swap, pop, loadslot)
+// become virtual registers; any operation that cannot be expressed over registers is run
+// as-is, after flushing the simulated stack onto the real one.
+// Only success paths execute in register form: on any failure, the simulated stack
+// is materialized and execution resumes in the Block's stack interpreter at the
+// failing operation, which reproduces the exact same error state.
+class RegisterProgram {
+    public:
+        using Register = uint32_t;
+
+        enum class Opcode {
+            ARGS,
+            FLUSH,
+            BINARY,
+            UNARY,
+            LOADSLOT,
+            OPERATION,
+        };
+
+        struct Instruction {
+            Opcode opcode;
+            OperationType type;
+            Register dst;
+            Register a;
+            Register b;
+            size_t count;
+            size_t source;
+            size_t snapshot;
+            std::shared_ptr<Operation> operation;
+            std::shared_ptr<Value> key;
+        };
+
+        static std::shared_ptr<RegisterProgram> fromBlock(const Block&);
+
+        size_t size() const;
+        size_t numRegisters() const;
+        const Instruction& at(size_t) const;
+
+        Operation::Result execute(MachineState&, Block&) const;
+
+        std::string describe() const;
+
+    private:
+        RegisterProgram();
+
+        class Compiler;
+
+        std::vector<Instruction> mInstructions;
+        std::vector<std::vector<Register>> mSnapshots;
+        std::vector<std::shared_ptr<Value>> mRegisters;
+
+        Operation::Result deoptimize(MachineState&, Block&, const std::vector<std::shared_ptr<Value>>&, const Instruction&) const;
+};
+
+#endif
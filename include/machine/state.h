@@ -32,10 +32,13 @@ class Value;
 class ValueTable;
 class Block;
 class MachineEventsListener;
+class WorkerPool;
+class HashCons;
 
 class MachineState {
     public:
         static constexpr uint32_t FORMAT_VERSION = 2;
+        static constexpr size_t DEFAULT_PARALLEL_THRESHOLD = 500;
 
         MachineState();
 
@@ -61,15 +64,36 @@ class MachineState {
 
         bool loadNativeLibrary(std::string);
 
+        bool registerExecution() const;
+        void setRegisterExecution(bool);
+
+        // if set, equal constants in a loaded program share one instance
+        bool hashConsing() const;
+        void setHashConsing(bool);
+
+        // if set, chains of map, filter and reduce run in a single pass where possible
+        bool pipelineFusion() const;
+        void setPipelineFusion(bool);
+
+        bool parallelExecution() const;
+        size_t parallelThreshold() const;
+        std::shared_ptr<WorkerPool> workerPool() const;
+        void setParallelExecution(size_t workers, size_t threshold = DEFAULT_PARALLEL_THRESHOLD);
+
+        std::unique_ptr<MachineState> fork();
+        bool isFork() const;
+
         void pushSlot(std::shared_ptr<Block>);
+        void pushSlot(std::shared_ptr<ValueTable>);
         void popSlot();
         std::shared_ptr<ValueTable> currentSlot() const;
 
         std::optional<Operation::Result> execute(const std::string& block = "main");
     private:
-        bool loadOneValue(ByteStream*);
-        bool loadOneValue(Parser*);
+        bool loadOneValue(ByteStream*, HashCons*);
+        bool loadOneValue(Parser*, HashCons*);
 
+        MachineState(MachineState*);
         MachineState(const MachineState&) = delete;
         MachineState& operator=(const MachineState&) = delete;
 
@@ -79,6 +103,14 @@ class MachineState {
 
         std::vector<std::shared_ptr<MachineEventsListener>> mListeners;
         std::stack<std::shared_ptr<ValueTable>> mSlots;
+
+        bool mRegisterExecution;
+        bool mHashConsing;
+        bool mPipelineFusion;
+
+        MachineState* mParent;
+        std::shared_ptr<WorkerPool> mWorkerPool;
+        size_t mParallelThreshold;
 };
 
 #endif
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_MACHINE_WORKERPOOL
+#define STUFF_MACHINE_WORKERPOOL
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+    public:
+        WorkerPool(size_t);
+        ~WorkerPool();
+
+        size_t size() const;
+
+        void submit(std::function<void()>);
+
+    private:
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        void work();
+
+        std::vector<std::thread> mThreads;
+        std::deque<std::function<void()>> mQueue;
+        std::mutex mLock;
+        std::condition_variable mReady;
+        bool mStopping;
+};
+
+#endif
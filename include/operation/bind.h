@@ -41,6 +41,8 @@ class PartialBind : public BaseOperation<PartialBind, OperationType::PARTIALBIND
 
         std::string describe() const override;
         bool equals(std::shared_ptr<Operation>) const override;
+        size_t hash() const override;
+        void hashCons(HashCons&) override;
         size_t serialize(Serializer*) const override;
         std::shared_ptr<Operation> clone() const override;
 
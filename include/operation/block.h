@@ -24,6 +24,9 @@
 #include <optional>
 
 class ValueTable;
+class RegisterProgram;
+class ParallelPlan;
+class PipelinePlan;
 class Serializer;
 class ByteStream;
 class Parser;
@@ -34,12 +37,15 @@ class Block : public DefaultConstructibleOperation<Block, OperationType::BLOCK>
         static std::shared_ptr<Block> fromParser(Parser*);
 
         Operation::Result doExecute(MachineState&) override;
+        Operation::Result run(MachineState&, size_t = 0);
         void add(std::shared_ptr<Operation>);
         size_t size() const;
         std::shared_ptr<Operation> at(size_t) const;
         std::string describe() const override;
         size_t serialize(Serializer*) const override;
         bool equals(std::shared_ptr<Operation>) const override;
+        size_t hash() const override;
+        void hashCons(HashCons&) override;
 
         std::shared_ptr<ValueTable> newSlot();
         void dropSlot();
@@ -53,8 +59,15 @@ class Block : public DefaultConstructibleOperation<Block, OperationType::BLOCK>
 
         std::shared_ptr<Operation> clone() const override;
 
+        std::shared_ptr<RegisterProgram> registerProgram() const;
+        std::shared_ptr<ParallelPlan> parallelPlan(MachineState&) const;
+        std::shared_ptr<PipelinePlan> pipelinePlan() const;
+
     private:
         std::vector<std::shared_ptr<Operation>> mOperations;
+        mutable std::shared_ptr<RegisterProgram> mRegisterProgram;
+        mutable std::shared_ptr<ParallelPlan> mParallelPlan;
+        mutable std::shared_ptr<PipelinePlan> mPipelinePlan;
         std::vector<std::shared_ptr<ValueTable>> mSlots;
         std::vector<std::string> mSlotNames;
     public:
@@ -32,6 +32,8 @@ class Call : public BaseOperation<Call, OperationType::CALL> {
         virtual std::string describe() const override;
         size_t serialize(Serializer*) const override;
         bool equals(std::shared_ptr<Operation>) const override;
+        size_t hash() const override;
+        void hashCons(HashCons&) override;
 
         std::shared_ptr<Operation> clone() const override;
 
@@ -18,10 +18,14 @@
 #define STUFF_OPERATION_FIND
 
 #include <operation/base_op.h>
+#include <value/shape.h>
 
 class Find : public DefaultConstructibleOperation<Find, OperationType::FIND, PreconditionArgc<2>> {
     public:
         virtual Operation::Result doExecute(MachineState&) override;
+
+    private:
+        ShapeCache mCache;
 };
 
 #endif
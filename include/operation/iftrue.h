@@ -30,6 +30,7 @@ class IfTrue : public BaseOperation<IfTrue, OperationType::IFTRUE, PreconditionA
         size_t serialize(Serializer*) const override;
 
         std::shared_ptr<Operation> clone() const override;
+        void hashCons(HashCons&) override;
 
         std::shared_ptr<Operation> op() const;
     private:
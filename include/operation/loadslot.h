@@ -30,6 +30,7 @@ class Loadslot : public BaseOperation<Loadslot, OperationType::LOADSLOT> {
         virtual std::string describe() const override;
         size_t serialize(Serializer*) const override;
         bool equals(std::shared_ptr<Operation>) const override;
+        size_t hash() const override;
 
         std::shared_ptr<Operation> clone() const override;
 
@@ -29,6 +29,7 @@ class Native : public BaseOperation<Native, OperationType::NATIVE> {
         virtual std::string describe() const override;
         size_t serialize(Serializer*) const override;
         bool equals(std::shared_ptr<Operation>) const override;
+        size_t hash() const override;
 
         std::string name() const;
         std::string fullyQualifiedName() const;
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_OPERATION_NUMERICCALLBACK
+#define STUFF_OPERATION_NUMERICCALLBACK
+
+#include <operation/op_types.h>
+#include <stdint.h>
+#include <memory>
+#include <optional>
+
+class Operation;
+
+// A map or reduce callback that amounts to one binary arithmetic operation, possibly
+// with a number bound as its top operand (as in "bind number 2 operation mul" or
+// "block { push number 2 mul }"). Such callbacks can run directly over packed numbers.
+struct NumericCallback {
+    OperationType operation;
+    std::optional<uint64_t> bound;
+
+    static std::optional<NumericCallback> fromOperation(const std::shared_ptr<Operation>&);
+};
+
+#endif
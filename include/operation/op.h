@@ -26,6 +26,7 @@
 
 class Serializer;
 class MachineState;
+class HashCons;
 
 class Operation : public std::enable_shared_from_this<Operation> {
     public:
@@ -50,6 +51,11 @@ class Operation : public std::enable_shared_from_this<Operation> {
         virtual size_t serialize(Serializer*) const;
 
         virtual bool equals(std::shared_ptr<Operation>) const;
+        // structural, and consistent with equals()
+        virtual size_t hash() const;
+
+        // interns constant operands; only valid before the operation is first executed
+        virtual void hashCons(HashCons&);
         virtual std::shared_ptr<Operation> clone() const = 0;
 
         template <typename T>
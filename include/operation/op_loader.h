@@ -17,9 +17,7 @@
 #ifndef STUFF_OPERATION_OPLOADER
 #define STUFF_OPERATION_OPLOADER
 
-#include <functional>
 #include <stream/byte_stream.h>
-#include <unordered_map>
 #include <memory>
 
 enum class OperationType : uint32_t;
@@ -29,22 +27,19 @@ class Parser;
 class OperationLoader {
     public:
         static OperationLoader* loader();
-        using LoaderFunction = std::function<std::shared_ptr<Operation>(ByteStream*)>;
-        using ParserFunction = std::function<std::shared_ptr<Operation>(Parser*)>;
-        void addLoader(OperationType, LoaderFunction);
-        void addParser(OperationType, ParserFunction);
+        using LoaderFunction = std::shared_ptr<Operation>(*)(ByteStream*);
+        using ParserFunction = std::shared_ptr<Operation>(*)(Parser*);
+        struct Entry {
+            LoaderFunction loader;
+            ParserFunction parser;
+        };
+        static const Entry* entry(OperationType);
         std::shared_ptr<Operation> fromByteStream(ByteStream*);
         std::shared_ptr<Operation> fromParser(Parser*);
 
     private:
-        std::unordered_map<OperationType, LoaderFunction> mLoaders;
-        std::unordered_map<OperationType, ParserFunction> mParsers;
         OperationLoader();
         ~OperationLoader();
 };
 
-#define OPERATION_TYPE(NAME, CLASS, TOKEN, STRING, NUMBER) \
-    void OpLoader ## CLASS () __attribute__((constructor, weak));
-#include <operation/op_types.def>
-
 #endif
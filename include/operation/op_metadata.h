@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_OPERATIONS_OPMETADATA
+#define STUFF_OPERATIONS_OPMETADATA
+
+#include <stdint.h>
+#include <array>
+#include <operation/op_types.h>
+
+// What an operation does to the machine, independently of its operands.
+// Stack effects are VARIABLE when they depend on runtime values (e.g. pack) or on
+// other operations (e.g. exec); cost is relative to a simple arithmetic operation.
+struct OperationMetadata {
+    static constexpr uint8_t VARIABLE = 0xFF;
+
+    enum Flags : uint32_t {
+        NONE = 0,
+        CAN_ERROR = 1 << 0,
+        READS_STORE = 1 << 1,
+        WRITES_STORE = 1 << 2,
+        READS_SLOTS = 1 << 3,
+        WRITES_SLOTS = 1 << 4,
+        USES_NATIVES = 1 << 5,
+        CONTROL = 1 << 6,
+        CALLS = 1 << 7,
+        ANYTHING = (1 << 8) - 1,
+    };
+
+    OperationType type;
+    uint8_t consumed;
+    uint8_t produced;
+    uint32_t flags;
+    uint32_t cost;
+
+    constexpr bool hasStackEffect() const { return consumed != VARIABLE && produced != VARIABLE; }
+    constexpr bool canError() const { return flags & CAN_ERROR; }
+    constexpr bool touchesStore() const { return flags & (READS_STORE | WRITES_STORE); }
+    constexpr bool touchesSlots() const { return flags & (READS_SLOTS | WRITES_SLOTS); }
+    constexpr bool touchesNatives() const { return flags & USES_NATIVES; }
+    constexpr bool hasSideEffects() const { return flags & (WRITES_STORE | WRITES_SLOTS | USES_NATIVES); }
+    constexpr bool isControl() const { return flags & CONTROL; }
+    constexpr bool calls() const { return flags & CALLS; }
+
+    // no side effects, no control flow and no other operations run
+    constexpr bool isPure() const { return !hasSideEffects() && !isControl() && !calls(); }
+
+    using Table = std::array<OperationMetadata, enumToNumber(std::numeric_limits<OperationType>::max()) + 1>;
+
+    static constexpr Table table() {
+        Table t{};
+        for (size_t i = 0; i < t.size(); ++i) {
+            t[i] = OperationMetadata{OperationType::NONE, VARIABLE, VARIABLE, ANYTHING, 0};
+        }
+#define OPERATION_METADATA(NAME, CONSUMED, PRODUCED, FLAGS, COST) \
+        t[enumToNumber(OperationType:: NAME)] = OperationMetadata{OperationType:: NAME, CONSUMED, PRODUCED, FLAGS, COST};
+#include <operation/op_metadata.def>
+        return t;
+    }
+};
+
+inline constexpr OperationMetadata::Table gOperationMetadata = OperationMetadata::table();
+
+constexpr const OperationMetadata& operationMetadata(OperationType op) {
+    return gOperationMetadata[enumToNumber(op)];
+}
+
+#define OPERATION_TYPE(NAME, CLASS, TOKEN, STRING, NUMBER) \
+    static_assert(operationMetadata(OperationType:: NAME).type == OperationType:: NAME, "no metadata for " STRING);
+#include <operation/op_types.def>
+
+#endif
@@ -36,6 +36,8 @@ class Select : public BaseOperation<Select, OperationType::SELECT> {
         size_t serialize(Serializer*) const override;
 
         bool equals(std::shared_ptr<Operation>) const override;
+        size_t hash() const override;
+        void hashCons(HashCons&) override;
 
         std::shared_ptr<Operation> clone() const override;
 
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_OPERATION_VIEW
+#define STUFF_OPERATION_VIEW
+
+#include <operation/base_op.h>
+
+class Slice : public DefaultConstructibleOperation<Slice, OperationType::SLICE, PreconditionArgc<3>> {
+    public:
+        virtual Operation::Result doExecute(MachineState&) override;
+};
+
+class Keys : public DefaultConstructibleOperation<Keys, OperationType::KEYS, PreconditionArgc<1>> {
+    public:
+        virtual Operation::Result doExecute(MachineState&) override;
+};
+
+class Values : public DefaultConstructibleOperation<Values, OperationType::VALUES, PreconditionArgc<1>> {
+    public:
+        virtual Operation::Result doExecute(MachineState&) override;
+};
+
+#endif
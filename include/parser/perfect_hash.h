@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_PARSER_PERFECTHASH
+#define STUFF_PARSER_PERFECTHASH
+
+#include <stdint.h>
+#include <array>
+#include <optional>
+#include <string_view>
+
+// A keyword table whose hash function is chosen at compile time so that no two keywords
+// collide, making a lookup one hash and one string comparison. Empty keys are ignored.
+template<typename T, size_t N, size_t SLOTS>
+class PerfectHash {
+    static_assert(SLOTS && (SLOTS & (SLOTS - 1)) == 0, "slots must be a power of two");
+    static_assert(N <= SLOTS, "too many keys for the table");
+
+    public:
+        struct Entry {
+            std::string_view key{};
+            T value{};
+        };
+
+        constexpr PerfectHash(const std::array<Entry, N>& entries) : mSeed(findSeed(entries)), mSlots() {
+            for (const auto& e : entries) {
+                if (!e.key.empty()) mSlots[slot(e.key, mSeed)] = e;
+            }
+        }
+
+        constexpr std::optional<T> find(std::string_view key) const {
+            const auto& e = mSlots[slot(key, mSeed)];
+            if (e.key.empty() || e.key != key) return std::nullopt;
+            return e.value;
+        }
+
+        constexpr uint32_t seed() const { return mSeed; }
+
+    private:
+        static constexpr size_t slot(std::string_view key, uint32_t seed) {
+            uint32_t h = 2166136261u ^ seed;
+            for (char c : key) {
+                h ^= (uint8_t)c;
+                h *= 16777619u;
+            }
+            h ^= h >> 15;
+            return h & (SLOTS - 1);
+        }
+
+        static constexpr uint32_t findSeed(const std::array<Entry, N>& entries) {
+            for (uint32_t seed = 0;; ++seed) {
+                std::array<bool, SLOTS> used{};
+                bool ok = true;
+                for (const auto& e : entries) {
+                    if (e.key.empty()) continue;
+                    auto s = slot(e.key, seed);
+                    if (used[s]) {
+                        ok = false;
+                        break;
+                    }
+                    used[s] = true;
+                }
+                if (ok) return seed;
+            }
+        }
+
+        uint32_t mSeed;
+        std::array<Entry, SLOTS> mSlots;
+};
+
+#endif
@@ -26,6 +26,12 @@
 
 class ByteStream {
     public:
+        // a range of the stream's bytes, which keeps the mapping alive
+        struct Slice {
+            std::shared_ptr<const char> data;
+            size_t size;
+        };
+
         static std::unique_ptr<ByteStream> anonymous(const uint8_t*, size_t);
         static std::unique_ptr<ByteStream> fromFile(int, size_t = 0);
 
@@ -46,6 +52,7 @@ class ByteStream {
 
        std::optional<std::string> readIdentifier(char marker = '\'');
        std::optional<std::string> readData();
+       std::optional<Slice> readSlice();
        std::optional<bool> readBoolean();
 
     private:
@@ -58,6 +65,7 @@ class ByteStream {
         int mFd;
         size_t mSize;
         uint8_t *mBasePointer;
+        std::shared_ptr<uint8_t> mMapping;
         std::optional<size_t> mOffset;
 
         friend std::unique_ptr<ByteStream> std::make_unique<ByteStream>(const uint8_t*&, size_t&);
@@ -19,8 +19,11 @@
 
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 
-template<typename ValueType>
+// Unique instances of ValueType, each constructed from its Key on first add().
+// Safe to share between threads.
+template<typename ValueType, typename Key = ValueType, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
 class Uniq {
     private:
         using VT = std::shared_ptr<ValueType>;
@@ -28,7 +31,8 @@ class Uniq {
     public:
         Uniq() = default;
 
-        VT add(const ValueType& v) {
+        VT add(const Key& v) {
+            std::lock_guard<std::mutex> lock(mMutex);
             VT sp(nullptr);
 
             auto i = mUniques.find(v), e = mUniques.end();
@@ -38,11 +42,23 @@ class Uniq {
             return sp;
         }
 
+        // adds v itself, unless an instance for an equal key is already present
+        VT add(const Key& k, VT v) {
+            std::lock_guard<std::mutex> lock(mMutex);
+
+            auto i = mUniques.find(k), e = mUniques.end();
+            if (i != e) return i->second;
+            mUniques.emplace(k, v);
+            return v;
+        }
+
         size_t size() const {
+            std::lock_guard<std::mutex> lock(mMutex);
             return mUniques.size();
         }
 
-        VT find(const ValueType& v) {
+        VT find(const Key& v) {
+            std::lock_guard<std::mutex> lock(mMutex);
             VT sp(nullptr);
 
             auto i = mUniques.find(v), e = mUniques.end();
@@ -52,9 +68,10 @@ class Uniq {
         }
 
     private:
-        using SelfType = Uniq<ValueType>;
+        using SelfType = Uniq<ValueType, Key, Hash, Equal>;
 
-        std::unordered_map<ValueType, VT> mUniques;
+        std::unordered_map<Key, VT, Hash, Equal> mUniques;
+        mutable std::mutex mMutex;
 
         Uniq(const SelfType&) = delete;
         SelfType& operator=(const SelfType&) = delete;
@@ -27,8 +27,7 @@ class Value_Atom : public Value {
         static std::shared_ptr<Value> fromByteStream(ByteStream* bs);
         static std::shared_ptr<Value> fromParser(Parser*);
 
-        Value_Atom(const std::string&);
-        std::string value() const;
+        const std::string& value() const;
         virtual std::string describe() const override;
         bool equals(std::shared_ptr<Value>) const override;
         size_t serialize(Serializer*) override;
@@ -38,7 +37,12 @@ class Value_Atom : public Value {
 
         VALUE_SUBCLASS(ValueType::ATOM, Value);
     private:
-        std::string mValue;
+        // atoms are interned and compared by address, so only Value::atom can construct them
+        friend class Value;
+        explicit Value_Atom(const std::string&);
+
+        const std::string mValue;
+        const size_t mHash;
 };
 
 #endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_HASHCONS
+#define STUFF_VALUE_HASHCONS
+
+#include <memory>
+#include <uniq/uniq.h>
+#include <value/hasher.h>
+#include <value/equater.h>
+
+class Value;
+
+// Makes structurally equal constants share one instance. Containers are rebuilt
+// from their interned children, and operations have their operands interned in
+// place, but are never merged themselves, as blocks carry runtime state.
+// Only meant for values that are not yet visible to running code.
+class HashCons {
+    public:
+        HashCons();
+
+        std::shared_ptr<Value> intern(std::shared_ptr<Value>);
+
+        template<typename T>
+        std::shared_ptr<T> intern(std::shared_ptr<T> v) {
+            return std::static_pointer_cast<T>(intern(std::static_pointer_cast<Value>(v)));
+        }
+
+        size_t size() const;
+
+    private:
+        std::shared_ptr<Value> internChildren(std::shared_ptr<Value>);
+
+        Uniq<Value, std::shared_ptr<Value>, ValueHasher, ValueEquater> mValues;
+};
+
+#endif
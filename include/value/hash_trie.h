@@ -0,0 +1,165 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_HASHTRIE
+#define STUFF_VALUE_HASHTRIE
+
+#include <stdint.h>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// A persistent hash array mapped trie from hashes to positions. Nodes are never
+// modified once built, so copying a trie is O(1) and inserting copies only the
+// path from the root to the new leaf.
+// The trie does not know about keys: lookups are given a predicate that tells
+// whether the key stored at a given position is the one being looked for.
+class HashTrie {
+    public:
+        static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+        HashTrie() = default;
+
+        template<typename Match>
+        uint32_t find(size_t hash, Match&& match) const {
+            hash = mix(hash);
+            const Node* node = mRoot.get();
+            for (unsigned shift = 0; node != nullptr; shift += BITS) {
+                if (shift >= HASH_BITS) {
+                    for (const auto& leaf : node->leaves) {
+                        if (leaf.hash == hash && match(leaf.pos)) return leaf.pos;
+                    }
+                    return NONE;
+                }
+                const uint32_t bit = bitFor(hash, shift);
+                if (node->datamap & bit) {
+                    const auto& leaf = node->leaves[index(node->datamap, bit)];
+                    return (leaf.hash == hash && match(leaf.pos)) ? leaf.pos : NONE;
+                }
+                if ((node->nodemap & bit) == 0) return NONE;
+                node = node->nodes[index(node->nodemap, bit)].get();
+            }
+            return NONE;
+        }
+
+        // returns false, leaving the trie untouched, if a matching entry already exists
+        template<typename Match>
+        bool insert(size_t hash, uint32_t pos, Match&& match) {
+            Leaf leaf{mix(hash), pos};
+            if (mRoot == nullptr) {
+                auto root = std::make_shared<Node>();
+                root->datamap = bitFor(leaf.hash, 0);
+                root->leaves.push_back(leaf);
+                mRoot = root;
+                return true;
+            }
+            auto root = insert(mRoot.get(), 0, leaf, match);
+            if (root == nullptr) return false;
+            mRoot = root;
+            return true;
+        }
+
+    private:
+        static constexpr unsigned BITS = 5;
+        static constexpr unsigned HASH_BITS = 8 * sizeof(size_t);
+
+        struct Leaf {
+            size_t hash;
+            uint32_t pos;
+        };
+
+        // below HASH_BITS, leaves and nodes are indexed by their bit in datamap/nodemap;
+        // past it, all hashes are equal and leaves is a plain collision list
+        struct Node {
+            uint32_t datamap = 0;
+            uint32_t nodemap = 0;
+            std::vector<Leaf> leaves;
+            std::vector<std::shared_ptr<Node>> nodes;
+        };
+
+        static size_t mix(size_t h) {
+            // spread weak value hashes (e.g. small numbers) across all the levels of the trie
+            h *= 0x9E3779B97F4A7C15ull;
+            return h ^ (h >> 32);
+        }
+        static uint32_t bitFor(size_t hash, unsigned shift) {
+            return 1u << ((hash >> shift) & 31);
+        }
+        static size_t index(uint32_t map, uint32_t bit) {
+            return __builtin_popcount(map & (bit - 1));
+        }
+
+        template<typename Match>
+        static std::shared_ptr<Node> insert(const Node* node, unsigned shift, const Leaf& leaf, Match& match) {
+            if (shift >= HASH_BITS) {
+                for (const auto& other : node->leaves) {
+                    if (other.hash == leaf.hash && match(other.pos)) return nullptr;
+                }
+                auto copy = std::make_shared<Node>(*node);
+                copy->leaves.push_back(leaf);
+                return copy;
+            }
+
+            const uint32_t bit = bitFor(leaf.hash, shift);
+            if (node->datamap & bit) {
+                const size_t i = index(node->datamap, bit);
+                const Leaf other = node->leaves[i];
+                if (other.hash == leaf.hash && match(other.pos)) return nullptr;
+                auto copy = std::make_shared<Node>(*node);
+                copy->datamap ^= bit;
+                copy->leaves.erase(copy->leaves.begin() + i);
+                copy->nodemap |= bit;
+                copy->nodes.insert(copy->nodes.begin() + index(copy->nodemap, bit), merge(other, leaf, shift + BITS));
+                return copy;
+            }
+            if (node->nodemap & bit) {
+                const size_t i = index(node->nodemap, bit);
+                auto child = insert(node->nodes[i].get(), shift + BITS, leaf, match);
+                if (child == nullptr) return nullptr;
+                auto copy = std::make_shared<Node>(*node);
+                copy->nodes[i] = child;
+                return copy;
+            }
+
+            auto copy = std::make_shared<Node>(*node);
+            copy->datamap |= bit;
+            copy->leaves.insert(copy->leaves.begin() + index(copy->datamap, bit), leaf);
+            return copy;
+        }
+
+        static std::shared_ptr<Node> merge(const Leaf& a, const Leaf& b, unsigned shift) {
+            auto node = std::make_shared<Node>();
+            if (shift >= HASH_BITS) {
+                node->leaves = {a, b};
+                return node;
+            }
+            const uint32_t ba = bitFor(a.hash, shift);
+            const uint32_t bb = bitFor(b.hash, shift);
+            if (ba == bb) {
+                node->nodemap = ba;
+                node->nodes.push_back(merge(a, b, shift + BITS));
+            } else {
+                node->datamap = ba | bb;
+                if (ba < bb) node->leaves = {a, b};
+                else node->leaves = {b, a};
+            }
+            return node;
+        }
+
+        std::shared_ptr<Node> mRoot;
+};
+
+#endif
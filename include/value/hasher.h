@@ -19,9 +19,86 @@
 
 #include <stdint.h>
 #include <memory>
+#include <atomic>
+#include <optional>
+#include <string>
+#include <value/value_types.h>
+#include <rtti/enum.h>
 
 class Value;
 
+// wyhash-style mixing of 64-bit words. The seed is chosen at random once per process,
+// so hash values must never be persisted or relied upon for ordering.
+class HashMix {
+    public:
+        static uint64_t seed();
+
+        // multiplies into 128 bits and folds the halves together
+        static uint64_t mum(uint64_t a, uint64_t b) {
+            __uint128_t r = (__uint128_t)a * b;
+            return (uint64_t)r ^ (uint64_t)(r >> 64);
+        }
+
+        static uint64_t of(uint64_t v) {
+            return mum(v ^ 0xa0761d6478bd642full, seed() ^ 0xe7037ed1a0b428dbull);
+        }
+
+        // order-sensitive: combine(combine(h, a), b) != combine(combine(h, b), a)
+        static uint64_t combine(uint64_t h, uint64_t v) {
+            return mum(h ^ 0x8ebc6af09c88c6e3ull, v ^ 0x589965cc75374cc3ull);
+        }
+
+        static uint64_t of(const std::string& s) {
+            return of(std::hash<std::string>()(s));
+        }
+
+        // a hash of v that differs between value types
+        static uint64_t tagged(ValueType t, uint64_t v) {
+            return combine(of(enumToNumber(t)), v);
+        }
+
+    private:
+        HashMix() = delete;
+};
+
+// A hash computed on first use. Safe to read from several threads, as values only
+// change before they are shared; reset() after any such change.
+class CachedHash {
+    public:
+        CachedHash() : mHash(0) {}
+
+        template<typename F>
+        size_t get(F&& compute) const {
+            size_t h = mHash.load(std::memory_order_relaxed);
+            if (h == 0) {
+                h = compute();
+                mHash.store(h, std::memory_order_relaxed);
+            }
+            return h;
+        }
+
+        // the hash, if it has been computed already
+        std::optional<size_t> peek() const {
+            size_t h = mHash.load(std::memory_order_relaxed);
+            if (h == 0) return std::nullopt;
+            return h;
+        }
+
+        // true if both hashes are known and differ, so the values cannot be equal
+        bool differs(const CachedHash& rhs) const {
+            auto h1 = peek(), h2 = rhs.peek();
+            return h1 && h2 && *h1 != *h2;
+        }
+
+        void reset() {
+            mHash.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        // 0 until computed
+        mutable std::atomic<size_t> mHash;
+};
+
 struct ValueHasher {
     size_t operator()(const std::shared_ptr<Value>& val) const;
 };
@@ -19,18 +19,61 @@
 
 #include <stdint.h>
 #include <memory>
+#include <functional>
+#include <array>
 
 class ValueIterator;
 class Value;
 
 class IterableValue {
     public:
+        static constexpr size_t CHUNK_SIZE = 32;
+
+        // called in order with each run of consecutive elements, until it returns false;
+        // a run is only valid for the duration of the call
+        using ChunkCallback = std::function<bool(const std::shared_ptr<Value>*, size_t)>;
+
         virtual size_t size() const = 0;
         virtual std::shared_ptr<Value> at(size_t) const = 0;
         virtual ~IterableValue();
 
-        ValueIterator begin();
-        ValueIterator end();
+        // returns false if the callback stopped the iteration
+        bool forEachChunk(size_t begin, size_t end, const ChunkCallback&) const;
+        bool forEachChunk(const ChunkCallback&) const;
+
+        // gathers elements produced one at a time into runs for a ChunkCallback
+        class ChunkBuffer {
+            public:
+                explicit ChunkBuffer(const ChunkCallback& f) : mCallback(f), mCount(0) {}
+
+                bool push(std::shared_ptr<Value> v) {
+                    mValues[mCount++] = std::move(v);
+                    return (mCount < CHUNK_SIZE) || flush();
+                }
+                bool flush() {
+                    const size_t n = mCount;
+                    mCount = 0;
+                    return (n == 0) || mCallback(mValues.data(), n);
+                }
+
+            private:
+                const ChunkCallback& mCallback;
+                std::array<std::shared_ptr<Value>, CHUNK_SIZE> mValues;
+                size_t mCount;
+        };
+
+        template<typename F>
+        bool forEach(F&& f) const {
+            return forEachChunk([&f] (const std::shared_ptr<Value>* p, size_t n) -> bool {
+                for (size_t i = 0; i < n; ++i) {
+                    if (!f(p[i])) return false;
+                }
+                return true;
+            });
+        }
+
+        ValueIterator begin() const;
+        ValueIterator end() const;
 
         bool equals(std::shared_ptr<IterableValue>) const;
 
@@ -42,6 +85,9 @@ class IterableValue {
         std::shared_ptr<Value> asValue();
     protected:
         IterableValue();
+
+        // containers override this to walk their own storage; by default, runs are gathered through at()
+        virtual bool doForEachChunk(size_t begin, size_t end, const ChunkCallback&) const;
 };
 
 #endif
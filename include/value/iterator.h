@@ -18,21 +18,51 @@
 #define STUFF_VALUE_ITERATOR
 
 #include <value/iterable.h>
+#include <cstddef>
+#include <iterator>
 
+// A random access iterator over any IterableValue, usable with standard algorithms.
+// Iterators are positions in one specific container: they compare by container identity
+// and index, and dereference through at(), so they yield values rather than references.
 class ValueIterator {
     public:
-        ValueIterator(IterableValue*, size_t = 0);
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::shared_ptr<Value>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::shared_ptr<Value>;
+        using reference = std::shared_ptr<Value>;
+
+        ValueIterator();
+        ValueIterator(const IterableValue*, size_t = 0);
+
         ValueIterator& operator++();
+        ValueIterator operator++(int);
         ValueIterator& operator--();
         ValueIterator operator--(int);
+        ValueIterator& operator+=(difference_type);
+        ValueIterator& operator-=(difference_type);
+        ValueIterator operator+(difference_type) const;
+        ValueIterator operator-(difference_type) const;
+        difference_type operator-(const ValueIterator&) const;
+
         std::shared_ptr<Value> operator*() const;
         std::shared_ptr<Value> operator->() const;
+        std::shared_ptr<Value> operator[](difference_type) const;
+
         bool operator==(const ValueIterator&) const;
         bool operator!=(const ValueIterator&) const;
+        bool operator<(const ValueIterator&) const;
+        bool operator>(const ValueIterator&) const;
+        bool operator<=(const ValueIterator&) const;
+        bool operator>=(const ValueIterator&) const;
+
+        size_t index() const;
 
     private:
-        IterableValue* mValue;
+        const IterableValue* mValue;
         size_t mIndex;
 };
 
+ValueIterator operator+(ValueIterator::difference_type, const ValueIterator&);
+
 #endif
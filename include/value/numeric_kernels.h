@@ -0,0 +1,42 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_NUMERICKERNELS
+#define STUFF_VALUE_NUMERICKERNELS
+
+#include <stdint.h>
+#include <stddef.h>
+#include <operation/op_types.h>
+
+// Bulk arithmetic over packed arrays of numbers. Each kernel uses the widest vector
+// unit the CPU supports at runtime (AVX2, then SSE2) and falls back to scalar code.
+class NumericKernels {
+    public:
+        static uint64_t sum(const uint64_t*, size_t);
+        static uint64_t product(const uint64_t*, size_t);
+        static bool equal(const uint64_t*, const uint64_t*, size_t);
+        static bool containsZero(const uint64_t*, size_t);
+
+        // out[i] = lhs OP in[i], with the operand order of the arithmetic operations;
+        // returns false if OP is not a binary arithmetic operation.
+        // DIVIDE and MODULO expect the caller to have ruled out zeros in the input.
+        static bool map(OperationType, uint64_t lhs, const uint64_t* in, uint64_t* out, size_t);
+
+    private:
+        NumericKernels() = delete;
+};
+
+#endif
@@ -19,6 +19,7 @@
 
 #include <value/value.h>
 #include <operation/op.h>
+#include <value/hasher.h>
 
 class PartialBind;
 class Block;
@@ -48,6 +49,7 @@ class Value_Operation : public Value {
         VALUE_SUBCLASS(ValueType::OPERATION, Value);
     private:
         std::shared_ptr<Operation> mValue;
+        CachedHash mHash;
 };
 
 #endif
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_ORDEREDHASH
+#define STUFF_VALUE_ORDEREDHASH
+
+#include <stdint.h>
+#include <memory>
+#include <value/hasher.h>
+#include <value/equater.h>
+#include <value/hash_trie.h>
+#include <value/persistent_vector.h>
+
+// An insertion-ordered, persistent hash index: entries live in a persistent vector
+// in the order they were added, and a hash trie maps keys to their positions.
+// Copies share all of their structure, and inserting into one copy is O(log n)
+// and leaves every other copy untouched. Entries must expose their key and its
+// hash as `key` and `hash`.
+template<typename Entry>
+class OrderedHash {
+    public:
+        OrderedHash() = default;
+
+        size_t size() const {
+            return mEntries.size();
+        }
+
+        const Entry& at(size_t i) const {
+            return mEntries[i];
+        }
+
+        // calls f(const Entry*, count) for each run of entries in [begin, end)
+        template<typename F>
+        void forEachChunk(size_t begin, size_t end, F&& f) const {
+            mEntries.forEachChunk(begin, end, f);
+        }
+
+        const Entry* find(const std::shared_ptr<Value>& key) const {
+            if (mEntries.empty()) return nullptr;
+            const size_t h = ValueHasher()(key);
+            auto pos = mIndex.find(h, [this, h, &key] (uint32_t p) {
+                const auto& e = mEntries[p];
+                return e.hash == h && ValueEquater()(e.key, key);
+            });
+            if (pos == HashTrie::NONE) return nullptr;
+            return &mEntries[pos];
+        }
+
+        bool insert(Entry e) {
+            e.hash = ValueHasher()(e.key);
+            const auto pos = (uint32_t)mEntries.size();
+            bool added = mIndex.insert(e.hash, pos, [this, &e] (uint32_t p) {
+                const auto& o = mEntries[p];
+                return o.hash == e.hash && ValueEquater()(o.key, e.key);
+            });
+            if (!added) return false;
+            mEntries.push_back(std::move(e));
+            return true;
+        }
+
+    private:
+        PersistentVector<Entry> mEntries;
+        HashTrie mIndex;
+};
+
+#endif
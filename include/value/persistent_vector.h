@@ -0,0 +1,165 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_PERSISTENTVECTOR
+#define STUFF_VALUE_PERSISTENTVECTOR
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+// An immutable vector with structural sharing: a 32-way trie of leaf chunks plus
+// a separate tail chunk, so that copying is O(1) and pushing a value only copies
+// the tail and, once every 32 pushes, a single path through the trie.
+template<typename T>
+class PersistentVector {
+    public:
+        static constexpr unsigned BITS = 5;
+        static constexpr size_t WIDTH = 1 << BITS;
+        static constexpr size_t MASK = WIDTH - 1;
+
+        PersistentVector() = default;
+
+        size_t size() const {
+            return mSize;
+        }
+        bool empty() const {
+            return mSize == 0;
+        }
+
+        const T& at(size_t i) const {
+            return chunkFor(i)->values[i & MASK];
+        }
+        const T& operator[](size_t i) const {
+            return at(i);
+        }
+
+        // calls f(const T*, count) for each contiguous run of elements in [begin, end)
+        template<typename F>
+        void forEachChunk(size_t begin, size_t end, F&& f) const {
+            while (begin < end) {
+                const Node* chunk = chunkFor(begin);
+                const size_t offset = begin & MASK;
+                size_t count = chunk->values.size() - offset;
+                if (count > end - begin) count = end - begin;
+                f(chunk->values.data() + offset, count);
+                begin += count;
+            }
+        }
+
+        void push_back(T value) {
+            if (mSize - tailOffset() < WIDTH) {
+                // a tail no other vector shares can grow in place
+                if (mTail == nullptr || mTail.use_count() != 1) {
+                    auto tail = std::make_shared<Node>();
+                    tail->values.reserve(WIDTH);
+                    if (mTail) tail->values = mTail->values;
+                    mTail = tail;
+                }
+                mTail->values.push_back(std::move(value));
+                ++mSize;
+                return;
+            }
+
+            if (mRoot == nullptr) {
+                mRoot = std::make_shared<Node>();
+            }
+            if ((mSize >> BITS) > (size_t(1) << mShift)) {
+                auto root = std::make_shared<Node>();
+                root->children.push_back(mRoot);
+                root->children.push_back(newPath(mShift, mTail));
+                mRoot = root;
+                mShift += BITS;
+            } else {
+                mRoot = pushTail(mShift, mRoot, mTail);
+            }
+
+            mTail = std::make_shared<Node>();
+            mTail->values.reserve(WIDTH);
+            mTail->values.push_back(std::move(value));
+            ++mSize;
+        }
+
+        // replaces the element at i, copying only the chunk and the trie path that lead to it
+        void set(size_t i, T value) {
+            if (i >= tailOffset()) {
+                if (mTail.use_count() != 1) mTail = std::make_shared<Node>(*mTail);
+                mTail->values[i & MASK] = std::move(value);
+                return;
+            }
+            mRoot = setPath(mShift, mRoot, i, std::move(value));
+        }
+
+    private:
+        struct Node {
+            std::vector<std::shared_ptr<Node>> children;
+            std::vector<T> values;
+        };
+
+        size_t tailOffset() const {
+            return mSize < WIDTH ? 0 : ((mSize - 1) >> BITS) << BITS;
+        }
+
+        const Node* chunkFor(size_t i) const {
+            if (i >= tailOffset()) return mTail.get();
+            const Node* node = mRoot.get();
+            for (unsigned level = mShift; level > 0; level -= BITS) {
+                node = node->children[(i >> level) & MASK].get();
+            }
+            return node;
+        }
+
+        static std::shared_ptr<Node> newPath(unsigned level, std::shared_ptr<Node> node) {
+            if (level == 0) return node;
+            auto path = std::make_shared<Node>();
+            path->children.push_back(newPath(level - BITS, node));
+            return path;
+        }
+
+        static std::shared_ptr<Node> setPath(unsigned level, const std::shared_ptr<Node>& parent, size_t i, T value) {
+            auto node = std::make_shared<Node>(*parent);
+            if (level == 0) {
+                node->values[i & MASK] = std::move(value);
+            } else {
+                const size_t idx = (i >> level) & MASK;
+                node->children[idx] = setPath(level - BITS, parent->children[idx], i, std::move(value));
+            }
+            return node;
+        }
+
+        std::shared_ptr<Node> pushTail(unsigned level, const std::shared_ptr<Node>& parent, std::shared_ptr<Node> tail) const {
+            const size_t idx = ((mSize - 1) >> level) & MASK;
+            auto node = std::make_shared<Node>(*parent);
+            std::shared_ptr<Node> insert;
+            if (level == BITS) {
+                insert = tail;
+            } else if (idx < parent->children.size()) {
+                insert = pushTail(level - BITS, parent->children[idx], tail);
+            } else {
+                insert = newPath(level - BITS, tail);
+            }
+            if (idx < node->children.size()) node->children[idx] = insert;
+            else node->children.push_back(insert);
+            return node;
+        }
+
+        size_t mSize = 0;
+        unsigned mShift = BITS;
+        std::shared_ptr<Node> mRoot;
+        std::shared_ptr<Node> mTail;
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_RANGE
+#define STUFF_VALUE_RANGE
+
+#include <value/value.h>
+#include <value/iterable.h>
+
+// The numbers first, first + step, ... up to but excluding last. Elements are
+// computed on access, and the range is only materialized when typecast to a tuple.
+class Value_Range : public Value, public IterableValue {
+    public:
+        static constexpr uint8_t MARKER = '%';
+
+        static std::shared_ptr<Value> fromByteStream(ByteStream* bs);
+        static std::shared_ptr<Value> fromParser(Parser*);
+
+        Value_Range(uint64_t first, uint64_t last, uint64_t step = 1);
+
+        uint64_t first() const;
+        uint64_t last() const;
+        uint64_t step() const;
+
+        size_t size() const override;
+        std::shared_ptr<Value> at(size_t) const override;
+
+        virtual std::string describe() const override;
+        bool equals(std::shared_ptr<Value>) const override;
+        size_t serialize(Serializer*) override;
+
+        size_t hash() const override;
+        std::shared_ptr<Value> clone() const override;
+
+        VALUE_SUBCLASS(ValueType::RANGE, Value);
+
+    protected:
+        std::shared_ptr<Value> doTypecast(ValueType) override;
+        bool doForEachChunk(size_t, size_t, const ChunkCallback&) const override;
+    private:
+        uint64_t mFirst;
+        uint64_t mLast;
+        uint64_t mStep;
+        size_t mSize;
+};
+
+#endif
@@ -18,6 +18,7 @@
 #define STUFF_VALUE_SET
 
 #include <value/value.h>
+#include <value/hasher.h>
 #include <value/value_set.h>
 #include <initializer_list>
 #include <value/iterable.h>
@@ -35,6 +36,7 @@ class Value_Set : public Value, public IterableValue, public SafeAppendableValue
 
         Value_Set();
         Value_Set(std::initializer_list<std::shared_ptr<Value>>);
+        explicit Value_Set(const ValueSet&);
 
         SafeAppendableValue<Value_Set*, std::shared_ptr<Value>>::BaseRetType tryAppend(std::shared_ptr<Value>) override;
         Appendable::RetType appendValue(std::shared_ptr<Value>) override;
@@ -58,8 +60,10 @@ class Value_Set : public Value, public IterableValue, public SafeAppendableValue
 
     protected:
         std::shared_ptr<Value> doTypecast(ValueType) override;
+        bool doForEachChunk(size_t, size_t, const ChunkCallback&) const override;
     private:
         ValueSet mSet;
+        CachedHash mHash;
 };
 
 #endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_SHAPE
+#define STUFF_VALUE_SHAPE
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+class Value;
+
+// The key set of a record table: an ordered list of atoms, each stored at the slot
+// of the same index. Shapes are reached by adding one atom at a time to the empty
+// shape, and each transition is created only once, so tables that add the same atoms
+// in the same order share a single Shape. Like atoms, shapes are never destroyed.
+class Shape {
+    public:
+        static constexpr size_t MAX_SIZE = 32;
+
+        static const Shape* empty();
+
+        uint32_t id() const;
+        size_t size() const;
+        const std::shared_ptr<Value>& keyAt(size_t) const;
+        std::optional<size_t> slotOf(const Value*) const;
+
+        // the shape with key appended; key must be an atom that is not already present
+        const Shape* with(const std::shared_ptr<Value>& key) const;
+
+    private:
+        Shape();
+        Shape(const Shape*, const std::shared_ptr<Value>&);
+
+        const uint32_t mId;
+        std::vector<std::shared_ptr<Value>> mKeys;
+        mutable std::mutex mLock;
+        mutable std::unordered_map<const Value*, std::unique_ptr<Shape>> mTransitions;
+};
+
+// Remembers the shape and slot of the last lookup at one site, so that looking up
+// the same key in a table of the same shape skips the search.
+// Safe to share between threads.
+class ShapeCache {
+    public:
+        ShapeCache() = default;
+
+        std::optional<size_t> slotOf(const Shape*, const Value*);
+
+    private:
+        std::atomic<uint64_t> mEntry{0};
+};
+
+#endif
@@ -19,6 +19,9 @@
 
 #include <value/value.h>
 #include <string>
+#include <value/hasher.h>
+#include <mutex>
+#include <value/string_storage.h>
 #include <value/iterable.h>
 #include <value/appendable.h>
 
@@ -32,7 +35,11 @@ class Value_String : public Value, public IterableValue, public AppendableValue<
         std::shared_ptr<Value> newEmptyOfSameType() override;
 
         Value_String(const std::u32string&);
+        explicit Value_String(const StringStorage&);
+        // valid UTF-8 owned elsewhere, only decoded once code points are needed
+        Value_String(std::shared_ptr<const char>, size_t);
         std::u32string value() const;
+        const StringStorage& storage() const;
         std::string utf8() const;
         virtual std::string describe() const override;
         bool equals(std::shared_ptr<Value>) const override;
@@ -40,6 +47,7 @@ class Value_String : public Value, public IterableValue, public AppendableValue<
 
         Value_String* append(char32_t);
         Value_String* append(const std::u32string&);
+        Value_String* append(const StringStorage&);
 
         AppendableValue<Value_String*, std::shared_ptr<Value>>::RetType tryAppend(std::shared_ptr<Value>) override;
         Appendable::RetType appendValue(std::shared_ptr<Value>) override;
@@ -51,8 +59,19 @@ class Value_String : public Value, public IterableValue, public AppendableValue<
         std::shared_ptr<Value> clone() const override;
 
         VALUE_SUBCLASS(ValueType::STRING, Value);
+    protected:
+        bool doForEachChunk(size_t, size_t, const ChunkCallback&) const override;
     private:
-        std::u32string mValue;
+        const StringStorage& decoded() const;
+
+        mutable StringStorage mValue;
+        mutable std::once_flag mDecoded;
+        // while set, mValue is filled from these bytes by decoded()
+        std::shared_ptr<const char> mBytes;
+        size_t mByteSize;
+        // code points in mBytes, counted once up front
+        size_t mLength;
+        CachedHash mHash;
 };
 
 #endif
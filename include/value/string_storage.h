@@ -0,0 +1,92 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_STRINGSTORAGE
+#define STUFF_VALUE_STRINGSTORAGE
+
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+// The code points of a string, stored as Latin-1, UCS-2 or UTF-32 depending on the
+// widest one. Storage only ever widens, and always starts as narrow as possible,
+// so two equal strings always have the same width.
+class StringStorage {
+    public:
+        enum class Width : uint8_t {
+            LATIN1 = 1,
+            UCS2 = 2,
+            UTF32 = 4,
+        };
+
+        StringStorage();
+        explicit StringStorage(std::u32string_view);
+        // the caller guarantees that every byte is a code point
+        static StringStorage latin1(std::string);
+
+        Width width() const;
+        size_t size() const;
+        char32_t at(size_t) const;
+
+        void append(char32_t);
+        void append(const StringStorage&);
+
+        bool operator==(const StringStorage&) const;
+        bool operator!=(const StringStorage&) const;
+        size_t hash() const;
+
+        // FNV-1a over code points, so that the hash does not depend on the width
+        static constexpr uint64_t HASH_BASIS = 0xcbf29ce484222325ull;
+        static uint64_t hashStep(uint64_t h, char32_t c) {
+            return (h ^ (uint32_t)c) * 0x100000001b3ull;
+        }
+
+        std::u32string u32() const;
+
+        // a view of code units of one width; Latin-1 units are unsigned
+        template<typename Unit>
+        struct Units {
+            const Unit* data;
+            size_t size;
+
+            const Unit* begin() const { return data; }
+            const Unit* end() const { return data + size; }
+            Unit operator[](size_t i) const { return data[i]; }
+        };
+
+        // calls f with Units<uint8_t>, Units<char16_t> or Units<char32_t>
+        template<typename F>
+        auto visit(F&& f) const {
+            return std::visit([&f] (const auto& s) {
+                using Unit = typename std::decay_t<decltype(s)>::value_type;
+                if constexpr (std::is_same_v<Unit, char>) {
+                    return f(Units<uint8_t>{(const uint8_t*)s.data(), s.size()});
+                } else {
+                    return f(Units<Unit>{s.data(), s.size()});
+                }
+            }, mUnits);
+        }
+
+    private:
+        void widen(Width);
+
+        // Latin-1 units are kept in a std::string, as its char_traits are standard
+        std::variant<std::string, std::u16string, std::u32string> mUnits;
+};
+
+#endif
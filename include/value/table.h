@@ -18,6 +18,7 @@
 #define STUFF_VALUE_TABLE
 
 #include <value/value.h>
+#include <value/hasher.h>
 #include <value/value_table.h>
 #include <initializer_list>
 #include <utility>
@@ -36,6 +37,7 @@ class Value_Table : public Value, public IterableValue, public SafeAppendableVal
 
         Value_Table();
         Value_Table(std::initializer_list<std::pair<std::shared_ptr<Value>,std::shared_ptr<Value>>>);
+        explicit Value_Table(const ValueTable&);
 
         SafeAppendableValue<Value_Table*, std::shared_ptr<Value>, std::shared_ptr<Value>>::BaseRetType tryAppend(std::shared_ptr<Value>, std::shared_ptr<Value>) override;
         Appendable::RetType appendValue(std::shared_ptr<Value>) override;
@@ -46,9 +48,17 @@ class Value_Table : public Value, public IterableValue, public SafeAppendableVal
         std::shared_ptr<Value> valueAt(size_t i) const;
         std::shared_ptr<Value> at(size_t i) const override { return pairAt(i); }
 
+        // calls f(key, value) for each entry in [begin, end) in order, until it returns false
+        template<typename F>
+        bool forEachEntry(size_t begin, size_t end, F&& f) const {
+            return mTable.forEach(begin, end, f);
+        }
+
         std::shared_ptr<Value> find(std::shared_ptr<Value>, std::shared_ptr<Value>) const;
         bool contains(std::shared_ptr<Value>) const override;
         std::shared_ptr<Value> retrieve(std::shared_ptr<Value>) const override;
+        // as retrieve, but record lookups go through the cache
+        std::shared_ptr<Value> retrieve(std::shared_ptr<Value>, ShapeCache&) const;
 
         virtual std::string describe() const override;
         bool equals(std::shared_ptr<Value>) const override;
@@ -61,8 +71,10 @@ class Value_Table : public Value, public IterableValue, public SafeAppendableVal
 
     protected:
         std::shared_ptr<Value> doTypecast(ValueType) override;
+        bool doForEachChunk(size_t, size_t, const ChunkCallback&) const override;
     private:
         ValueTable mTable;
+        CachedHash mHash;
 };
 
 #endif
@@ -18,8 +18,10 @@
 #define STUFF_VALUE_TUPLE
 
 #include <value/value.h>
+#include <value/hasher.h>
 #include <memory>
 #include <vector>
+#include <value/value_vector.h>
 #include <initializer_list>
 #include <value/iterable.h>
 #include <value/appendable.h>
@@ -35,12 +37,14 @@ class Value_Tuple : public Value, public IterableValue, public SafeAppendableVal
 
         Value_Tuple();
         Value_Tuple(std::initializer_list<std::shared_ptr<Value>>);
+        explicit Value_Tuple(const ValueVector&);
 
         SafeAppendableValue<Value_Tuple*, std::shared_ptr<Value>>::BaseRetType tryAppend(std::shared_ptr<Value>) override;
         Appendable::RetType appendValue(std::shared_ptr<Value>) override;
 
         size_t size() const override;
         std::shared_ptr<Value> at(size_t i) const override;
+        const ValueVector& values() const;
         virtual std::string describe() const override;
         bool equals(std::shared_ptr<Value>) const override;
         size_t serialize(Serializer*) override;
@@ -52,8 +56,10 @@ class Value_Tuple : public Value, public IterableValue, public SafeAppendableVal
     
     protected:
         std::shared_ptr<Value> doTypecast(ValueType) override;
+        bool doForEachChunk(size_t, size_t, const ChunkCallback&) const override;
     private:
-        std::vector<std::shared_ptr<Value>> mValues;
+        ValueVector mValues;
+        CachedHash mHash;
 };
 
 #endif
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_UTF8
+#define STUFF_VALUE_UTF8
+
+#include <stdint.h>
+#include <stddef.h>
+#include <optional>
+#include <string>
+#include <value/string_storage.h>
+
+// A validating UTF-8 transcoder. Runs of ASCII are scanned 16 bytes at a time, and
+// all-ASCII input is copied straight into Latin-1 storage.
+// Malformed input includes truncated and overlong sequences, stray continuation
+// bytes, surrogates and code points past U+10FFFF.
+class Utf8 {
+    public:
+        static constexpr char32_t REPLACEMENT = 0xFFFD;
+
+        // returns nothing if the input is malformed
+        static std::optional<StringStorage> decode(const char*, size_t);
+        // replaces each malformed byte with REPLACEMENT
+        static StringStorage decodeLossy(const char*, size_t);
+        // code points that cannot be encoded become REPLACEMENT
+        static std::string encode(const StringStorage&);
+
+        static bool validate(const char*, size_t);
+
+        // these expect valid input, and agree with the decoded StringStorage
+        static size_t length(const char*, size_t);
+        static size_t hash(const char*, size_t);
+
+        // length of the run of ASCII bytes at the start of the input
+        static size_t asciiPrefix(const char*, size_t);
+
+    private:
+        Utf8() = delete;
+};
+
+#endif
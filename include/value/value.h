@@ -47,6 +47,7 @@ class Value_Atom;
 class Value_Error;
 class Value_Set;
 class Value_String;
+class Value_Range;
 
 class Value : public std::enable_shared_from_this<Value> {
     public:
@@ -65,6 +66,7 @@ class Value : public std::enable_shared_from_this<Value> {
         static std::shared_ptr<Value_Table> table(std::initializer_list<std::pair<std::shared_ptr<Value>,std::shared_ptr<Value>>>);
         static std::shared_ptr<Value_Set> set(std::initializer_list<std::shared_ptr<Value>>);
         static std::shared_ptr<Value_Atom> atom(const std::string&);
+        static std::shared_ptr<Value_Range> range(uint64_t first, uint64_t last, uint64_t step = 1);
 
         static std::shared_ptr<Value> fromByteStream(ByteStream*);
         static std::shared_ptr<Value> fromParser(Parser*);
@@ -90,12 +92,16 @@ class Value : public std::enable_shared_from_this<Value> {
         virtual bool equals(std::shared_ptr<Value>) const = 0;
 
         virtual size_t hash() const = 0;
+        // values are immutable, so a clone shares all of its children: only values
+        // that can be appended to return a fresh object, and that shares its storage;
+        // operation values clone their operation, which may keep per-instance state
         virtual std::shared_ptr<Value> clone() const = 0;
 
         std::shared_ptr<Value> typecast(ValueType);
 
     protected:
         virtual std::shared_ptr<Value> doTypecast(ValueType);
+        std::shared_ptr<Value> sharedClone() const;
         Value();
 
     private:
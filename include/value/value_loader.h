@@ -17,9 +17,7 @@
 #ifndef STUFF_VALUE_VALUELOADER
 #define STUFF_VALUE_VALUELOADER
 
-#include <functional>
 #include <stream/byte_stream.h>
-#include <unordered_map>
 #include <memory>
 
 enum class ValueType : uint32_t;
@@ -29,22 +27,16 @@ class Parser;
 class ValueLoader {
     public:
         static ValueLoader* loader();
-        using LoaderFunction = std::function<std::shared_ptr<Value>(ByteStream*)>;
-        using ParserFunction = std::function<std::shared_ptr<Value>(Parser*)>;
-        void addLoader(uint8_t, LoaderFunction);
-        void addParser(ValueType, ParserFunction);
+        using LoaderFunction = std::shared_ptr<Value>(*)(ByteStream*);
+        using ParserFunction = std::shared_ptr<Value>(*)(Parser*);
+        static LoaderFunction loaderFor(uint8_t marker);
+        static ParserFunction parserFor(ValueType);
         std::shared_ptr<Value> fromByteStream(ByteStream*);
         std::shared_ptr<Value> fromParser(Parser*);
 
     private:
-        std::unordered_map<uint8_t, LoaderFunction> mLoaders;
-        std::unordered_map<ValueType, ParserFunction> mParsers;
         ValueLoader();
         ~ValueLoader();
 };
 
-#define VALUE_TYPE(ID, TOKEN, STRING, NUMBER, CLASS) \
-    void ValueLoader ## CLASS () __attribute__((constructor, weak));
-#include <value/value_types.def>
-
 #endif
@@ -17,9 +17,7 @@
 #ifndef STUFF_VALUE_VALUESET
 #define STUFF_VALUE_VALUESET
 
-#include <unordered_set>
-#include <value/hasher.h>
-#include <value/equater.h>
+#include <value/ordered_hash.h>
 
 class ValueSet {
     public:
@@ -29,9 +27,22 @@ class ValueSet {
         size_t size() const;
         std::shared_ptr<Value> at(size_t) const;
 
+        // calls f(value) for each value in [begin, end) in order, until it returns false
+        template<typename F>
+        bool forEach(size_t begin, size_t end, F&& f) const {
+            bool more = true;
+            mSet.forEachChunk(begin, end, [&] (const Entry* p, size_t n) {
+                for (size_t i = 0; more && i < n; ++i) more = f(p[i].key);
+            });
+            return more;
+        }
+
     private:
-        using Set = std::unordered_set<std::shared_ptr<Value>, ValueHasher, ValueEquater>;
-        Set mSet;
+        struct Entry {
+            std::shared_ptr<Value> key;
+            size_t hash;
+        };
+        OrderedHash<Entry> mSet;
 };
 
 #endif
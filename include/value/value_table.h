@@ -17,23 +17,79 @@
 #ifndef STUFF_VALUE_VALUETABLE
 #define STUFF_VALUE_VALUETABLE
 
-#include <unordered_map>
-#include <value/hasher.h>
-#include <value/equater.h>
+#include <value/ordered_hash.h>
+#include <value/persistent_vector.h>
+#include <value/shape.h>
+#include <optional>
+#include <variant>
+#include <vector>
 
+// Storage for tables, in insertion order. As long as every key is a number and they
+// are close enough together, keys index directly into an array of entry positions
+// with no hashing; a key that is not a number, or that would need more than
+// DENSITY slots per entry, switches the table to a hash index for good.
+// Tables whose keys are all atoms are stored as records instead: a shared Shape
+// maps each key to a slot, and the values are kept in an array in slot order.
 class ValueTable {
     public:
+        static constexpr size_t DENSITY = 2;
+        static constexpr size_t DENSE_SLACK = 32;
+
         ValueTable();
+        bool dense() const;
+        // the shape of a record table, or nullptr for any other table
+        const Shape* shape() const;
         bool add(std::shared_ptr<Value>, std::shared_ptr<Value>);
         std::shared_ptr<Value> find(std::shared_ptr<Value>) const;
+        std::shared_ptr<Value> find(std::shared_ptr<Value>, ShapeCache&) const;
         size_t size() const;
         std::shared_ptr<Value> keyAt(size_t) const;
         std::shared_ptr<Value> valueAt(size_t) const;
         std::shared_ptr<Value> at(size_t) const;
 
+        // calls f(key, value) for each entry in [begin, end) in order, until it returns false
+        template<typename F>
+        bool forEach(size_t begin, size_t end, F&& f) const {
+            bool more = true;
+            auto visit = [&] (const Entry* p, size_t n) {
+                for (size_t i = 0; more && i < n; ++i) more = f(p[i].key, p[i].value);
+            };
+            if (auto rc = std::get_if<Record>(&mStorage)) {
+                for (size_t i = begin; more && i < end; ++i) more = f(rc->shape->keyAt(i), rc->values[i]);
+            } else if (auto dn = std::get_if<Dense>(&mStorage)) {
+                dn->entries.forEachChunk(begin, end, visit);
+            } else {
+                std::get<Hashed>(mStorage).forEachChunk(begin, end, visit);
+            }
+            return more;
+        }
+
     private:
-        using ValueMap = std::unordered_map<std::shared_ptr<Value>, std::shared_ptr<Value>, ValueHasher, ValueEquater>;
-        ValueMap mMap;
+        struct Entry {
+            std::shared_ptr<Value> key;
+            std::shared_ptr<Value> value;
+            size_t hash;
+        };
+        struct Dense {
+            uint64_t base;
+            PersistentVector<Entry> entries;
+            // for each key from base, one past the position of its entry, or 0 if absent
+            PersistentVector<uint32_t> slots;
+        };
+        struct Record {
+            const Shape* shape;
+            std::vector<std::shared_ptr<Value>> values;
+        };
+        using Hashed = OrderedHash<Entry>;
+
+        const Entry& entryAt(size_t) const;
+        // returns nothing if the key does not fit in the dense index
+        static std::optional<bool> addDense(Dense&, uint64_t, const Entry&);
+        // returns nothing if the key can't be added to the record
+        static std::optional<bool> addRecord(Record&, const std::shared_ptr<Value>&, const std::shared_ptr<Value>&);
+        void makeHashed();
+
+        std::variant<Dense, Record, Hashed> mStorage;
 };
 
 #endif
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_VALUEVECTOR
+#define STUFF_VALUE_VALUEVECTOR
+
+#include <stdint.h>
+#include <memory>
+#include <functional>
+#include <array>
+#include <optional>
+#include <variant>
+#include <vector>
+#include <operation/op_types.h>
+#include <value/persistent_vector.h>
+
+class Value;
+
+// Element storage for tuples. Up to INLINE_SIZE elements are stored in the object itself,
+// with no heap buffer. Past that, as long as every element is a number, they are packed
+// as raw integers in a persistent vector. Otherwise, small vectors are kept flat and
+// past SMALL_SIZE elements they switch to a persistent vector of values.
+// Copies share persistent storage, and so do slices of it.
+class ValueVector {
+    public:
+        static constexpr size_t INLINE_SIZE = 4;
+        static constexpr size_t SMALL_SIZE = 16;
+        static constexpr size_t CHUNK_SIZE = 32;
+
+        ValueVector();
+
+        size_t size() const;
+        bool isInline() const;
+        bool persistent() const;
+        bool packed() const;
+        std::shared_ptr<Value> at(size_t) const;
+
+        // calls f(const std::shared_ptr<Value>*, count) for each run of elements in [begin, end)
+        // until it returns false; packed numbers are boxed one run at a time
+        bool forEachChunk(size_t begin, size_t end, const std::function<bool(const std::shared_ptr<Value>*, size_t)>& f) const;
+
+        void push_back(std::shared_ptr<Value>);
+        void append(const ValueVector&);
+        ValueVector slice(size_t begin, size_t end) const;
+
+        // bulk operations on packed numbers; they return nothing if either
+        // vector is not packed, or if OP would fail on some element
+        std::optional<bool> equalNumbers(const ValueVector&) const;
+        std::optional<uint64_t> sumNumbers() const;
+        // combines each element's hash into h, as Value_Tuple does
+        std::optional<uint64_t> hashNumbers(uint64_t h) const;
+        std::optional<ValueVector> mapNumbers(OperationType, uint64_t lhs) const;
+        std::optional<uint64_t> reduceNumbers(OperationType, uint64_t initial) const;
+
+    private:
+        using Inline = std::array<std::shared_ptr<Value>, INLINE_SIZE>;
+        using Flat = std::vector<std::shared_ptr<Value>>;
+        using Persistent = PersistentVector<std::shared_ptr<Value>>;
+        using Packed = PersistentVector<uint64_t>;
+
+        // moves inline elements to the heap, packed if they and the next value are all numbers
+        void spill(const std::shared_ptr<Value>& next);
+        void unpack();
+        void makePersistent();
+        void pushNumber(uint64_t);
+
+        template<typename F>
+        void forEachNumberChunk(F&& f) const {
+            std::get<Packed>(mStorage).forEachChunk(mBegin, mBegin + mSize, f);
+        }
+
+        std::variant<Inline, Packed, Flat, Persistent> mStorage;
+        size_t mBegin;
+        size_t mSize;
+};
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2019 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STUFF_VALUE_VIEW
+#define STUFF_VALUE_VIEW
+
+#include <value/value.h>
+#include <value/hasher.h>
+#include <value/iterable.h>
+
+class Value_Table;
+class Value_Tuple;
+
+// A window onto another container that shares its storage: a run of consecutive
+// elements of any iterable value, or the keys or values of a table. Elements are
+// read from the source on access, and a view is only copied when typecast.
+class Value_View : public Value, public IterableValue {
+    public:
+        static constexpr uint8_t MARKER = 'V';
+
+        enum class Kind : uint8_t {
+            SLICE = 0,
+            KEYS = 1,
+            VALUES = 2,
+        };
+
+        static std::shared_ptr<Value> fromByteStream(ByteStream* bs);
+        static std::shared_ptr<Value> fromParser(Parser*);
+
+        // elements [begin, end) of an iterable value; tuples and ranges slice into values of their
+        // own type, which share storage all the same. Returns nullptr if the bounds are invalid.
+        static std::shared_ptr<Value> slice(std::shared_ptr<Value>, size_t begin, size_t end);
+        static std::shared_ptr<Value_View> keys(std::shared_ptr<Value_Table>);
+        static std::shared_ptr<Value_View> values(std::shared_ptr<Value_Table>);
+
+        Value_View(Kind, std::shared_ptr<Value> source, size_t offset, size_t size);
+
+        Kind kind() const;
+        std::shared_ptr<Value> source() const;
+        size_t offset() const;
+
+        // a copy of the elements, as a string for slices of strings and as a tuple otherwise
+        std::shared_ptr<Value> materialize() const;
+
+        size_t size() const override;
+        std::shared_ptr<Value> at(size_t) const override;
+
+        virtual std::string describe() const override;
+        bool equals(std::shared_ptr<Value>) const override;
+        size_t serialize(Serializer*) override;
+
+        size_t hash() const override;
+        std::shared_ptr<Value> clone() const override;
+
+        VALUE_SUBCLASS(ValueType::VIEW, Value);
+
+    protected:
+        std::shared_ptr<Value> doTypecast(ValueType) override;
+        bool doForEachChunk(size_t, size_t, const ChunkCallback&) const override;
+    private:
+        static std::shared_ptr<Value> make(Kind, std::shared_ptr<Value>, size_t, size_t);
+        std::shared_ptr<Value_Tuple> toTuple() const;
+
+        Kind mKind;
+        std::shared_ptr<Value> mSource;
+        const IterableValue* mIterable;
+        const Value_Table* mTable;
+        size_t mOffset;
+        size_t mSize;
+        CachedHash mHash;
+};
+
+#endif
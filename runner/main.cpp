@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
+#include <thread>
 #include <fstream>
 #include <streambuf>
 #include <sstream>
@@ -34,11 +35,28 @@ static std::unique_ptr<ByteStream> readEntireFile(const char* path) {
 }
 
 int main(int argc, char** argv) {
-    if (argc < 2) {
+    bool parallel = false;
+    bool hashCons = false;
+    bool fusion = false;
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; ++arg) {
+        std::string opt(argv[arg]);
+        if (opt == "--parallel") parallel = true;
+        else if (opt == "--hash-cons") hashCons = true;
+        else if (opt == "--fuse-pipelines") fusion = true;
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[arg]);
+            exit(1);
+        }
+    }
+    if (arg >= argc) {
         exit(1);
     }
-    auto in_file = readEntireFile(argv[1]);
+    auto in_file = readEntireFile(argv[arg]);
     MachineState ms;
+    if (parallel) ms.setParallelExecution(std::thread::hardware_concurrency());
+    ms.setHashConsing(hashCons);
+    ms.setPipelineFusion(fusion);
     size_t count = ms.load(in_file.get());
     printf("loaded %zu values\n", count);
     auto ok = ms.execute();
@@ -0,0 +1,516 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ir/parallel_plan.h>
+#include <operation/block.h>
+#include <operation/push.h>
+#include <operation/load.h>
+#include <operation/iftrue.h>
+#include <operation/call.h>
+#include <operation/bind.h>
+#include <operation/op_metadata.h>
+#include <machine/state.h>
+#include <machine/worker_pool.h>
+#include <value/operation.h>
+#include <value/tuple.h>
+#include <value/value_store.h>
+#include <rtti/rtti.h>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+    constexpr size_t NO_REGION = std::numeric_limits<size_t>::max();
+
+    size_t addCost(size_t a, size_t b) {
+        return (a > std::numeric_limits<size_t>::max() - b) ? std::numeric_limits<size_t>::max() : a + b;
+    }
+    size_t mulCost(size_t a, size_t b) {
+        if (a && b > std::numeric_limits<size_t>::max() / a) return std::numeric_limits<size_t>::max();
+        return a * b;
+    }
+
+    ParallelPlan::StackEffect effect(size_t consumed, size_t produced, size_t cost) {
+        return ParallelPlan::StackEffect{
+            .consumed = consumed,
+            .produced = produced,
+            .cost = cost,
+        };
+    }
+
+    ParallelPlan::StackEffect then(ParallelPlan::StackEffect a, ParallelPlan::StackEffect b) {
+        int64_t depth = (int64_t)a.produced - (int64_t)a.consumed;
+        int64_t low = std::min(-(int64_t)a.consumed, depth - (int64_t)b.consumed);
+        depth = depth - (int64_t)b.consumed + (int64_t)b.produced;
+        return effect((size_t)-low, (size_t)(depth - low), addCost(a.cost, b.cost));
+    }
+}
+
+class ParallelPlan::Analyzer {
+    public:
+        enum class Kind {
+            UNKNOWN,
+            DIVERGES,
+            KNOWN,
+        };
+
+        struct Flow {
+            Kind kind;
+            StackEffect effect;
+        };
+
+        // operation values known to be on the stack, top last, nullptr for anything else
+        using Callees = std::vector<std::shared_ptr<Operation>>;
+
+        Analyzer(MachineState& ms) : mState(ms), mLowestHit(NO_REGION) {}
+
+        // every name resolved so far, and what it resolved to
+        const std::unordered_map<std::string, std::shared_ptr<Value>>& dependencies() const {
+            return mDependencies;
+        }
+
+        Flow operation(std::shared_ptr<Operation> op, const Callees& callees, bool nested) {
+            const auto& md = operationMetadata(op->getClassId());
+            switch (op->getClassId()) {
+                case OperationType::STORESLOT:
+                    // only a callee's own slot is private to the computation
+                    if (nested) return known(effect(md.consumed, md.produced, md.cost));
+                    return unknown();
+                case OperationType::BLOCK:
+                    return callee(op, nested);
+                case OperationType::CALL: {
+                    auto cl = runtime_ptr_cast<Call>(op);
+                    auto target = resolve(cl->name());
+                    if (target == nullptr) return unknown();
+                    auto f = callee(target, nested);
+                    if (f.kind != Kind::KNOWN) return f;
+                    return known(then(effect(0, cl->arguments()->size(), md.cost), f.effect));
+                }
+                case OperationType::EXEC: {
+                    auto target = calleeAt(callees, 0);
+                    if (target == nullptr) return unknown();
+                    auto f = callee(target, nested);
+                    if (f.kind != Kind::KNOWN) return f;
+                    return known(then(effect(1, 0, md.cost), f.effect));
+                }
+                case OperationType::PARTIALBIND: {
+                    auto f = callee(runtime_ptr_cast<PartialBind>(op)->callable(), nested);
+                    if (f.kind != Kind::KNOWN) return f;
+                    return known(then(effect(0, 1, md.cost), f.effect));
+                }
+                case OperationType::MAP:
+                case OperationType::FILTER: {
+                    auto target = calleeAt(callees, 0);
+                    if (target == nullptr) return unknown();
+                    auto f = callee(target, nested);
+                    if (f.kind != Kind::KNOWN) return f;
+                    if (f.effect.consumed != f.effect.produced || f.effect.consumed > 1) return unknown();
+                    return known(effect(md.consumed, md.produced, mulCost(LOOP_WEIGHT, addCost(f.effect.cost, md.cost))));
+                }
+                case OperationType::REDUCE: {
+                    auto target = calleeAt(callees, 1);
+                    if (target == nullptr) return unknown();
+                    auto f = callee(target, nested);
+                    if (f.kind != Kind::KNOWN) return f;
+                    if (f.effect.consumed != f.effect.produced + 1 || f.effect.consumed > 2) return unknown();
+                    return known(effect(md.consumed, md.produced, mulCost(LOOP_WEIGHT, addCost(f.effect.cost, md.cost))));
+                }
+                default:
+                    if (md.isPure() && md.hasStackEffect()) return known(effect(md.consumed, md.produced, md.cost));
+                    return unknown();
+            }
+        }
+
+        void apply(Callees& callees, std::shared_ptr<Operation> op, StackEffect f) {
+            std::shared_ptr<Operation> top = nullptr;
+            std::shared_ptr<Operation> second = nullptr;
+            switch (op->getClassId()) {
+                case OperationType::PUSH:
+                    if (auto vop = runtime_ptr_cast<Value_Operation>(runtime_ptr_cast<Push>(op)->value())) {
+                        top = vop->value();
+                    }
+                    break;
+                case OperationType::LOAD:
+                    top = resolve(runtime_ptr_cast<Load>(op)->key());
+                    break;
+                case OperationType::DUP:
+                    top = second = calleeAt(callees, 0);
+                    break;
+                case OperationType::SWAP:
+                    top = calleeAt(callees, 1);
+                    second = calleeAt(callees, 0);
+                    break;
+                default:
+                    break;
+            }
+            for (size_t i = 0; i < f.consumed && !callees.empty(); ++i) callees.pop_back();
+            for (size_t i = 0; i < f.produced; ++i) callees.push_back(nullptr);
+            if (f.produced > 0) callees.back() = top;
+            if (f.produced > 1) callees[callees.size() - 2] = second;
+        }
+
+    private:
+        struct Frame {
+            const Block* block;
+            Flow assumption;
+        };
+
+        std::shared_ptr<Operation> resolve(const std::string& name) {
+            auto val = mState.value_store().retrieve(name);
+            mDependencies.emplace(name, val);
+            if (val == nullptr) return nullptr;
+            if (auto vop = runtime_ptr_cast<Value_Operation>(val)) return vop->value();
+            return nullptr;
+        }
+
+        MachineState& mState;
+        std::unordered_map<std::string, std::shared_ptr<Value>> mDependencies;
+        std::unordered_map<const Block*, Flow> mDone;
+        std::vector<Frame> mInProgress;
+        size_t mLowestHit;
+
+        static Flow known(StackEffect e) {
+            return Flow{Kind::KNOWN, e};
+        }
+        static Flow unknown() {
+            return Flow{Kind::UNKNOWN, effect(0, 0, 0)};
+        }
+        static Flow diverges() {
+            return Flow{Kind::DIVERGES, effect(0, 0, 0)};
+        }
+
+        static std::shared_ptr<Operation> calleeAt(const Callees& callees, size_t i) {
+            if (i >= callees.size()) return nullptr;
+            return callees[callees.size() - 1 - i];
+        }
+
+        Flow callee(std::shared_ptr<Operation> op, bool nested) {
+            if (auto blk = std::dynamic_pointer_cast<Block>(op)) {
+                auto f = block(blk.get());
+                if (f.kind == Kind::KNOWN) f.effect.cost = addCost(f.effect.cost, 1);
+                return f;
+            }
+            return operation(op, {}, nested);
+        }
+
+        // recursion is solved by first assuming that recursive calls never return, then
+        // checking that the effect found from the exit paths is a fixed point
+        Flow block(const Block* blk) {
+            auto done = mDone.find(blk);
+            if (done != mDone.end()) return done->second;
+            for (size_t i = 0; i < mInProgress.size(); ++i) {
+                if (mInProgress[i].block == blk) {
+                    mLowestHit = std::min(mLowestHit, i);
+                    return mInProgress[i].assumption;
+                }
+            }
+
+            const size_t frame = mInProgress.size();
+            const size_t outerHit = mLowestHit;
+            mLowestHit = NO_REGION;
+            mInProgress.push_back(Frame{blk, diverges()});
+            auto flow = walk(*blk);
+            size_t hit = mLowestHit;
+            if (hit == frame && flow.kind == Kind::KNOWN) {
+                mInProgress[frame].assumption = flow;
+                mLowestHit = NO_REGION;
+                auto again = walk(*blk);
+                hit = std::min(hit, mLowestHit);
+                if (again.kind == Kind::KNOWN &&
+                    again.effect.consumed == flow.effect.consumed &&
+                    again.effect.produced == flow.effect.produced) {
+                    flow = again;
+                    flow.effect.cost = mulCost(LOOP_WEIGHT, flow.effect.cost);
+                } else flow = unknown();
+            }
+            mInProgress.pop_back();
+
+            if (hit >= frame) {
+                mDone.emplace(blk, flow);
+                mLowestHit = outerHit;
+            } else mLowestHit = std::min(outerHit, hit);
+            return flow;
+        }
+
+        Flow walk(const Block& blk) {
+            const int64_t start = -(int64_t)blk.numSlotValues();
+            int64_t depth = start;
+            int64_t low = start;
+            size_t cost = 0;
+            bool looped = false;
+            bool consistent = true;
+            std::optional<int64_t> exit;
+            Callees callees;
+
+            auto exitAt = [&exit, &consistent] (int64_t d) -> void {
+                if (exit.has_value() && exit.value() != d) consistent = false;
+                exit = d;
+            };
+
+            for (size_t i = 0; i < blk.size(); ++i) {
+                auto op = blk.at(i);
+                switch (op->getClassId()) {
+                    case OperationType::IFTRUE: {
+                        cost = addCost(cost, operationMetadata(OperationType::IFTRUE).cost);
+                        low = std::min(low, depth - 1);
+                        depth -= 1;
+                        apply(callees, op, effect(1, 0, 0));
+                        auto inner = runtime_ptr_cast<IfTrue>(op)->op();
+                        if (inner->isOfType(OperationType::BREAK)) exitAt(depth);
+                        else if (inner->isOfType(OperationType::LOOP)) {
+                            if (depth != start) return unknown();
+                            looped = true;
+                        } else {
+                            auto f = operation(inner, callees, true);
+                            if (f.kind == Kind::UNKNOWN) return f;
+                            if (f.kind == Kind::KNOWN) {
+                                if (f.effect.consumed != f.effect.produced) return unknown();
+                                low = std::min(low, depth - (int64_t)f.effect.consumed);
+                                cost = addCost(cost, f.effect.cost);
+                                apply(callees, inner, f.effect);
+                            }
+                        }
+                        continue;
+                    }
+                    case OperationType::BREAK:
+                        exitAt(depth);
+                        goto out;
+                    case OperationType::LOOP:
+                        if (depth != start) return unknown();
+                        looped = true;
+                        goto out;
+                    default: {
+                        auto f = operation(op, callees, true);
+                        if (f.kind == Kind::UNKNOWN) return f;
+                        if (f.kind == Kind::DIVERGES) goto out;
+                        low = std::min(low, depth - (int64_t)f.effect.consumed);
+                        depth = depth - (int64_t)f.effect.consumed + (int64_t)f.effect.produced;
+                        cost = addCost(cost, f.effect.cost);
+                        apply(callees, op, f.effect);
+                        continue;
+                    }
+                }
+            }
+            exitAt(depth);
+
+out:
+            if (!consistent) return unknown();
+            if (!exit.has_value()) return diverges();
+            if (looped) cost = mulCost(LOOP_WEIGHT, cost);
+            return known(effect((size_t)-low, (size_t)(exit.value() - low), cost));
+        }
+};
+
+ParallelPlan::ParallelPlan(MachineState& ms) : mThreshold(ms.parallelThreshold()) {}
+
+std::optional<ParallelPlan::StackEffect> ParallelPlan::effectOf(std::shared_ptr<Operation> op, MachineState& ms) {
+    Analyzer an(ms);
+    auto f = an.operation(op, {}, false);
+    if (f.kind == Analyzer::Kind::KNOWN) return f.effect;
+    return std::nullopt;
+}
+
+std::shared_ptr<ParallelPlan> ParallelPlan::fromBlock(const Block& blk, MachineState& ms) {
+    struct Entry {
+        size_t begin;
+        size_t end;
+        size_t values;
+        size_t cost;
+    };
+
+    auto plan = std::shared_ptr<ParallelPlan>(new ParallelPlan(ms));
+    plan->mRegionAt.resize(blk.size(), NO_REGION);
+
+    Analyzer an(ms);
+    Analyzer::Callees callees;
+    std::vector<Entry> entries;
+    size_t available = 0;
+
+    auto groupsOf = [] (std::vector<Entry>::const_iterator b, std::vector<Entry>::const_iterator e) -> std::vector<Group> {
+        std::vector<Group> groups;
+        for (; b != e; ++b) groups.push_back(Group{b->begin, b->end, b->cost});
+        return groups;
+    };
+    auto barrier = [&] () -> void {
+        if (entries.size() > 1) plan->addRegion(groupsOf(entries.begin(), entries.end()), plan->mThreshold);
+        entries.clear();
+        available = 0;
+    };
+
+    for (size_t i = 0; i < blk.size(); ++i) {
+        auto op = blk.at(i);
+        auto f = an.operation(op, callees, false);
+        if (f.kind != Analyzer::Kind::KNOWN) {
+            barrier();
+            callees.clear();
+            continue;
+        }
+        an.apply(callees, op, f.effect);
+
+        if (f.effect.consumed > available) {
+            barrier();
+            continue;
+        }
+
+        size_t need = f.effect.consumed;
+        size_t first = entries.size();
+        while (need > 0) {
+            --first;
+            need -= std::min(need, entries[first].values);
+        }
+        size_t cost = f.effect.cost;
+        size_t values = f.effect.produced;
+        for (size_t j = first; j < entries.size(); ++j) {
+            cost = addCost(cost, entries[j].cost);
+            values += entries[j].values;
+        }
+        values -= f.effect.consumed;
+        if (entries.size() - first > 1) plan->addRegion(groupsOf(entries.begin() + first, entries.end()), plan->mThreshold);
+
+        Entry merged{first < entries.size() ? entries[first].begin : i, i + 1, values, cost};
+        available = available - f.effect.consumed + f.effect.produced;
+        entries.erase(entries.begin() + first, entries.end());
+        entries.push_back(merged);
+    }
+    barrier();
+
+    plan->mDependencies.assign(an.dependencies().begin(), an.dependencies().end());
+    return plan;
+}
+
+void ParallelPlan::addRegion(const std::vector<Group>& groups, size_t threshold) {
+    size_t expensive = std::count_if(groups.begin(), groups.end(), [threshold] (const Group& g) -> bool {
+        return g.cost >= threshold;
+    });
+    if (expensive < 2) return;
+
+    const size_t idx = mRegions.size();
+    mRegions.push_back(Region{groups.front().begin, groups.back().end, groups});
+    mNextRegion.push_back(NO_REGION);
+
+    size_t* link = &mRegionAt[groups.front().begin];
+    while (*link != NO_REGION && mRegions[*link].end > mRegions[idx].end) link = &mNextRegion[*link];
+    mNextRegion[idx] = *link;
+    *link = idx;
+}
+
+size_t ParallelPlan::size() const {
+    return mRegions.size();
+}
+
+const ParallelPlan::Region& ParallelPlan::at(size_t i) const {
+    return mRegions.at(i);
+}
+
+std::optional<size_t> ParallelPlan::regionAt(size_t begin, size_t limit) const {
+    if (mRegions.empty() || begin >= mRegionAt.size()) return std::nullopt;
+    size_t r = mRegionAt[begin];
+    while (r != NO_REGION && mRegions[r].end > limit) r = mNextRegion[r];
+    if (r == NO_REGION) return std::nullopt;
+    return r;
+}
+
+bool ParallelPlan::isCurrent(MachineState& ms) const {
+    if (mThreshold != ms.parallelThreshold()) return false;
+    auto& store = ms.value_store();
+    return std::all_of(mDependencies.begin(), mDependencies.end(), [&store] (const auto& dep) -> bool {
+        return store.retrieve(dep.first) == dep.second;
+    });
+}
+
+Operation::Result ParallelPlan::run(MachineState& ms, Block& blk, size_t begin, size_t end) const {
+    size_t i = begin;
+    while (i < end) {
+        if (auto r = regionAt(i, end)) {
+            auto res = execute(ms, blk, r.value());
+            if (res != Operation::Result::SUCCESS) return res;
+            i = mRegions[r.value()].end;
+            continue;
+        }
+        auto res = blk.at(i)->execute(ms);
+        if (res == Operation::Result::AGAIN) continue;
+        if (res != Operation::Result::SUCCESS) return res;
+        ++i;
+    }
+    return Operation::Result::SUCCESS;
+}
+
+Operation::Result ParallelPlan::execute(MachineState& ms, Block& blk, size_t r) const {
+    struct Join {
+        Join(size_t n) : forks(n), results(n, Operation::Result::SUCCESS), claimed(new std::atomic<bool>[n]), failed(n), pending(n) {
+            for (size_t i = 0; i < n; ++i) claimed[i] = false;
+        }
+
+        std::vector<std::unique_ptr<MachineState>> forks;
+        std::vector<Operation::Result> results;
+        std::unique_ptr<std::atomic<bool>[]> claimed;
+        // the first group that did not succeed; groups after it are never started
+        std::atomic<size_t> failed;
+        std::mutex lock;
+        std::condition_variable done;
+        size_t pending;
+    };
+
+    const auto& region = mRegions[r];
+    const size_t n = region.groups.size();
+    auto join = std::make_shared<Join>(n);
+    for (size_t g = 0; g < n; ++g) join->forks[g] = ms.fork();
+
+    // whoever claims a group first runs it; the caller only ever waits on groups that are
+    // already running elsewhere, so nested regions cannot deadlock the pool
+    auto runGroup = [this, &blk, &region] (Join* j, size_t g) -> void {
+        if (j->claimed[g].exchange(true)) return;
+        if (g < j->failed) {
+            const auto& group = region.groups[g];
+            j->results[g] = run(*j->forks[g], blk, group.begin, group.end);
+            if (j->results[g] != Operation::Result::SUCCESS) {
+                size_t f = j->failed;
+                while (g < f && !j->failed.compare_exchange_weak(f, g));
+            }
+        }
+        std::unique_lock<std::mutex> lk(j->lock);
+        if (--j->pending == 0) j->done.notify_all();
+    };
+
+    bool first = true;
+    for (size_t g = 0; g < n; ++g) {
+        if (region.groups[g].cost < mThreshold) continue;
+        if (first) {
+            first = false;
+            continue;
+        }
+        ms.workerPool()->submit([runGroup, join, g] () -> void { runGroup(join.get(), g); });
+    }
+    for (size_t g = 0; g < n; ++g) runGroup(join.get(), g);
+
+    {
+        std::unique_lock<std::mutex> lk(join->lock);
+        join->done.wait(lk, [&join] () -> bool { return join->pending == 0; });
+    }
+
+    // forks go away here, as they may hold the last reference to the pool
+    auto res = Operation::Result::SUCCESS;
+    for (size_t g = 0; g < n; ++g) {
+        auto fork = std::move(join->forks[g]);
+        if (res != Operation::Result::SUCCESS) continue;
+        std::vector<std::shared_ptr<Value>> values;
+        while (!fork->stack().empty()) values.push_back(fork->stack().pop());
+        for (auto v = values.rbegin(); v != values.rend(); ++v) ms.stack().push(*v);
+        res = join->results[g];
+    }
+
+    return res;
+}
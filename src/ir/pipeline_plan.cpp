@@ -0,0 +1,178 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ir/pipeline_plan.h>
+#include <ir/parallel_plan.h>
+#include <operation/block.h>
+#include <operation/push.h>
+#include <operation/numeric_callback.h>
+#include <machine/state.h>
+#include <value/operation.h>
+#include <value/boolean.h>
+#include <value/iterable.h>
+#include <value/range.h>
+#include <value/tuple.h>
+#include <value/number.h>
+#include <rtti/rtti.h>
+#include <algorithm>
+
+namespace {
+    std::shared_ptr<Value> constantAt(const Block& blk, size_t i) {
+        auto op = blk.at(i);
+        if (op == nullptr) return nullptr;
+        if (auto push = op->asClass<Push>()) return push->value();
+        return nullptr;
+    }
+
+    std::shared_ptr<Value> callbackAt(const Block& blk, size_t i) {
+        auto val = constantAt(blk, i);
+        if (val && val->isOfClass<Value_Operation>()) return val;
+        return nullptr;
+    }
+
+    bool isOperation(const Block& blk, size_t i, OperationType type) {
+        auto op = blk.at(i);
+        return op && op->isOfType(type);
+    }
+
+    bool numericMap(const PipelinePlan::Stage& stage) {
+        if (stage.type != OperationType::MAP) return false;
+        auto numeric = NumericCallback::fromOperation(stage.callback->asClass<Value_Operation>()->value());
+        return numeric && numeric->bound;
+    }
+}
+
+std::shared_ptr<PipelinePlan> PipelinePlan::fromBlock(const Block& blk) {
+    auto plan = std::shared_ptr<PipelinePlan>(new PipelinePlan());
+    plan->mPipelineAt.resize(blk.size());
+
+    size_t i = 0;
+    while (i < blk.size()) {
+        Pipeline pl{i, i, {}, nullptr, nullptr};
+        size_t j = i;
+        while (auto cbk = callbackAt(blk, j)) {
+            if (isOperation(blk, j + 1, OperationType::MAP) || isOperation(blk, j + 1, OperationType::FILTER)) {
+                pl.stages.push_back(Stage{blk.at(j + 1)->getClassId(), cbk});
+                j += 2;
+                continue;
+            }
+            auto initial = constantAt(blk, j + 1);
+            if (initial && isOperation(blk, j + 2, OperationType::REDUCE)) {
+                pl.reducer = cbk;
+                pl.initial = initial;
+                j += 3;
+            }
+            break;
+        }
+
+        if (pl.stages.size() + (pl.reducer ? 1 : 0) < 2) {
+            ++i;
+            continue;
+        }
+        pl.end = j;
+        plan->mPipelineAt[i] = plan->mPipelines.size();
+        plan->mPipelines.push_back(pl);
+        i = j;
+    }
+
+    return plan;
+}
+
+size_t PipelinePlan::size() const {
+    return mPipelines.size();
+}
+
+const PipelinePlan::Pipeline& PipelinePlan::at(size_t i) const {
+    return mPipelines.at(i);
+}
+
+std::optional<size_t> PipelinePlan::pipelineAt(size_t i) const {
+    if (i >= mPipelineAt.size()) return std::nullopt;
+    return mPipelineAt[i];
+}
+
+bool PipelinePlan::fusible(MachineState& ms, const Pipeline& pl, const std::shared_ptr<Value>& vcnt) const {
+    auto tpl = vcnt->asClass<Value_Tuple>();
+    if (tpl == nullptr && !vcnt->isOfClass<Value_Range>()) return false;
+
+    // packed numbers are faster through the vector kernels, intermediate tuples and all
+    if (tpl && tpl->values().packed() && std::all_of(pl.stages.begin(), pl.stages.end(), numericMap)) {
+        if (pl.reducer == nullptr) return false;
+        auto numeric = NumericCallback::fromOperation(pl.reducer->asClass<Value_Operation>()->value());
+        if (numeric && !numeric->bound && pl.initial->isOfClass<Value_Number>()) return false;
+    }
+
+    for (const auto& stage : pl.stages) {
+        auto f = ParallelPlan::effectOf(stage.callback->asClass<Value_Operation>()->value(), ms);
+        if (!f || f->consumed != f->produced || f->consumed > 1) return false;
+    }
+    if (pl.reducer) {
+        auto f = ParallelPlan::effectOf(pl.reducer->asClass<Value_Operation>()->value(), ms);
+        if (!f || f->consumed != f->produced + 1 || f->consumed > 2) return false;
+    }
+
+    return true;
+}
+
+Operation::Result PipelinePlan::execute(MachineState& ms, Block& blk, size_t n) const {
+    const auto& pl = mPipelines[n];
+    if (!ms.stack().hasAtLeast(1)) return deoptimize(ms, blk, pl, ms.stack().size(), nullptr);
+
+    auto vcnt = ms.stack().pop();
+    const size_t base = ms.stack().size();
+    if (!fusible(ms, pl, vcnt)) return deoptimize(ms, blk, pl, base, vcnt);
+
+    auto iter = IterableValue::asIterable(vcnt);
+    ValueVector out;
+    auto acc = pl.initial;
+    bool ok = iter->forEach([&] (std::shared_ptr<Value> itm) -> bool {
+        for (const auto& stage : pl.stages) {
+            ms.stack().push(itm);
+            if (stage.callback->asClass<Value_Operation>()->execute(ms) != Operation::Result::SUCCESS) return false;
+            auto res = ms.stack().pop();
+            if (stage.type == OperationType::MAP) {
+                itm = res;
+                continue;
+            }
+            auto bln = runtime_ptr_cast<Value_Boolean>(res);
+            if (bln == nullptr) return false;
+            if (!bln->value()) return true;
+        }
+
+        if (pl.reducer) {
+            ms.stack().push(itm);
+            ms.stack().push(acc);
+            if (pl.reducer->asClass<Value_Operation>()->execute(ms) != Operation::Result::SUCCESS) return false;
+            acc = ms.stack().pop();
+        } else out.push_back(itm);
+        return true;
+    });
+    if (!ok) return deoptimize(ms, blk, pl, base, vcnt);
+
+    if (pl.reducer) ms.stack().push(acc);
+    else ms.stack().push(std::make_shared<Value_Tuple>(out));
+    return Operation::Result::SUCCESS;
+}
+
+Operation::Result PipelinePlan::deoptimize(MachineState& ms, Block& blk, const Pipeline& pl, size_t base, const std::shared_ptr<Value>& vcnt) const {
+    while (ms.stack().size() > base) ms.stack().pop();
+    if (vcnt) ms.stack().push(vcnt);
+
+    for (size_t i = pl.begin; i < pl.end; ++i) {
+        if (i != pl.begin) ms.onExecutingOperation(i);
+        auto res = blk.at(i)->execute(ms);
+        if (res != Operation::Result::SUCCESS) return res;
+    }
+    return Operation::Result::SUCCESS;
+}
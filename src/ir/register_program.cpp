@@ -0,0 +1,367 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ir/register_program.h>
+#include <operation/block.h>
+#include <operation/push.h>
+#include <operation/loadslot.h>
+#include <operation/arith.h>
+#include <operation/logical.h>
+#include <machine/state.h>
+#include <value/value.h>
+#include <value/number.h>
+#include <value/boolean.h>
+#include <value/error.h>
+#include <value/string.h>
+#include <value/table.h>
+#include <value/type.h>
+#include <stream/indenting_stream.h>
+#include <rtti/rtti.h>
+
+class RegisterProgram::Compiler {
+    public:
+        Compiler(RegisterProgram& p) : mProgram(p) {}
+
+        void compile(const Block& blk) {
+            for (size_t i = 0; i < blk.size(); ++i) {
+                compileOne(blk.at(i), i);
+            }
+            flush();
+        }
+
+    private:
+        RegisterProgram& mProgram;
+        std::vector<Register> mStack;
+
+        Register newRegister(std::shared_ptr<Value> k = nullptr) {
+            mProgram.mRegisters.push_back(k);
+            return (Register)(mProgram.mRegisters.size() - 1);
+        }
+
+        size_t snapshot() {
+            mProgram.mSnapshots.push_back(mStack);
+            return mProgram.mSnapshots.size() - 1;
+        }
+
+        Instruction instruction(Opcode opc, size_t source) {
+            return Instruction{
+                .opcode = opc,
+                .type = OperationType::NONE,
+                .dst = 0,
+                .a = 0,
+                .b = 0,
+                .count = 0,
+                .source = source,
+                .snapshot = 0,
+                .operation = nullptr,
+                .key = nullptr,
+            };
+        }
+
+        Register pop() {
+            auto r = mStack.back();
+            mStack.pop_back();
+            return r;
+        }
+
+        void require(size_t n, size_t source) {
+            if (mStack.size() >= n) return;
+
+            auto in = instruction(Opcode::ARGS, source);
+            in.count = n - mStack.size();
+            in.snapshot = snapshot();
+            in.a = newRegister();
+            if (in.count > 1) in.b = newRegister();
+
+            if (in.count > 1) mStack.insert(mStack.begin(), in.b);
+            mStack.insert(mStack.begin() + (in.count > 1 ? 1 : 0), in.a);
+            mProgram.mInstructions.push_back(in);
+        }
+
+        void flush() {
+            if (mStack.empty()) return;
+            auto in = instruction(Opcode::FLUSH, 0);
+            in.snapshot = snapshot();
+            mProgram.mInstructions.push_back(in);
+            mStack.clear();
+        }
+
+        void binary(std::shared_ptr<Operation> op, size_t source) {
+            require(2, source);
+            auto in = instruction(Opcode::BINARY, source);
+            in.snapshot = snapshot();
+            in.type = op->getClassId();
+            in.operation = op;
+            in.a = pop();
+            in.b = pop();
+            in.dst = newRegister();
+            mStack.push_back(in.dst);
+            mProgram.mInstructions.push_back(in);
+        }
+
+        void unary(std::shared_ptr<Operation> op, size_t source) {
+            require(1, source);
+            auto in = instruction(Opcode::UNARY, source);
+            in.snapshot = snapshot();
+            in.type = op->getClassId();
+            in.operation = op;
+            in.a = pop();
+            in.dst = newRegister();
+            mStack.push_back(in.dst);
+            mProgram.mInstructions.push_back(in);
+        }
+
+        void compileOne(std::shared_ptr<Operation> op, size_t source) {
+            switch (op->getClassId()) {
+                case OperationType::NOP:
+                    return;
+                case OperationType::PUSH:
+                    mStack.push_back(newRegister(op->asClass<Push>()->value()));
+                    return;
+                case OperationType::DUP:
+                    require(1, source);
+                    mStack.push_back(mStack.back());
+                    return;
+                case OperationType::SWAP:
+                    require(2, source);
+                    std::swap(mStack[mStack.size() - 1], mStack[mStack.size() - 2]);
+                    return;
+                case OperationType::POP:
+                    require(1, source);
+                    pop();
+                    return;
+                case OperationType::LOADSLOT: {
+                    auto in = instruction(Opcode::LOADSLOT, source);
+                    in.snapshot = snapshot();
+                    in.key = Value::fromString(op->asClass<Loadslot>()->key());
+                    in.dst = newRegister();
+                    mStack.push_back(in.dst);
+                    mProgram.mInstructions.push_back(in);
+                    return;
+                }
+                case OperationType::ADD:
+                case OperationType::SUBTRACT:
+                case OperationType::MULTIPLY:
+                case OperationType::DIVIDE:
+                case OperationType::MODULO:
+                case OperationType::AND:
+                case OperationType::OR:
+                case OperationType::XOR:
+                case OperationType::EQUALS:
+                    binary(op, source);
+                    return;
+                case OperationType::POSITIVE:
+                case OperationType::NEGATIVE:
+                case OperationType::ZERO:
+                case OperationType::NOT:
+                case OperationType::TYPEOF:
+                    unary(op, source);
+                    return;
+                default: {
+                    flush();
+                    auto in = instruction(Opcode::OPERATION, source);
+                    in.type = op->getClassId();
+                    in.operation = op;
+                    mProgram.mInstructions.push_back(in);
+                    return;
+                }
+            }
+        }
+};
+
+RegisterProgram::RegisterProgram() = default;
+
+std::shared_ptr<RegisterProgram> RegisterProgram::fromBlock(const Block& blk) {
+    std::shared_ptr<RegisterProgram> prg(new RegisterProgram());
+    Compiler(*prg).compile(blk);
+    return prg;
+}
+
+size_t RegisterProgram::size() const {
+    return mInstructions.size();
+}
+
+size_t RegisterProgram::numRegisters() const {
+    return mRegisters.size();
+}
+
+const RegisterProgram::Instruction& RegisterProgram::at(size_t i) const {
+    return mInstructions.at(i);
+}
+
+namespace {
+template<typename T>
+std::shared_ptr<Value> evalNumber(Operation* op, Value_Number* a, Value_Number* b) {
+    return static_cast<T*>(op)->eval(a, b);
+}
+template<typename T>
+std::shared_ptr<Value> evalBoolean(Operation* op, Value_Boolean* a, Value_Boolean* b) {
+    return static_cast<T*>(op)->eval(a, b);
+}
+
+std::shared_ptr<Value> evalBinary(const RegisterProgram::Instruction& in, const std::shared_ptr<Value>& a, const std::shared_ptr<Value>& b) {
+    switch (in.type) {
+        case OperationType::EQUALS:
+            return Value::fromBoolean(a->equals(b));
+        case OperationType::AND:
+        case OperationType::OR:
+        case OperationType::XOR: {
+            auto ba = runtime_ptr_cast<Value_Boolean>(a);
+            auto bb = runtime_ptr_cast<Value_Boolean>(b);
+            if (ba == nullptr || bb == nullptr) return nullptr;
+            if (in.type == OperationType::AND) return evalBoolean<And>(in.operation.get(), ba, bb);
+            if (in.type == OperationType::OR) return evalBoolean<Or>(in.operation.get(), ba, bb);
+            return evalBoolean<Xor>(in.operation.get(), ba, bb);
+        }
+        default: break;
+    }
+
+    auto na = runtime_ptr_cast<Value_Number>(a);
+    auto nb = runtime_ptr_cast<Value_Number>(b);
+    if (na == nullptr || nb == nullptr) return nullptr;
+    switch (in.type) {
+        case OperationType::ADD: return evalNumber<Add>(in.operation.get(), na, nb);
+        case OperationType::SUBTRACT: return evalNumber<Subtract>(in.operation.get(), na, nb);
+        case OperationType::MULTIPLY: return evalNumber<Multiply>(in.operation.get(), na, nb);
+        case OperationType::DIVIDE: return evalNumber<Divide>(in.operation.get(), na, nb);
+        case OperationType::MODULO: return evalNumber<Modulo>(in.operation.get(), na, nb);
+        default: return nullptr;
+    }
+}
+
+std::shared_ptr<Value> evalUnary(const RegisterProgram::Instruction& in, const std::shared_ptr<Value>& a) {
+    if (in.type == OperationType::TYPEOF) return Value::type(a->getClassId());
+    if (in.type == OperationType::NOT) {
+        auto ba = runtime_ptr_cast<Value_Boolean>(a);
+        if (ba == nullptr) return nullptr;
+        return static_cast<Not*>(in.operation.get())->eval(ba);
+    }
+
+    auto na = runtime_ptr_cast<Value_Number>(a);
+    if (na == nullptr) return nullptr;
+    switch (in.type) {
+        case OperationType::POSITIVE: return static_cast<Positive*>(in.operation.get())->eval(na);
+        case OperationType::NEGATIVE: return static_cast<Negative*>(in.operation.get())->eval(na);
+        case OperationType::ZERO: return static_cast<Zero*>(in.operation.get())->eval(na);
+        default: return nullptr;
+    }
+}
+}
+
+Operation::Result RegisterProgram::deoptimize(MachineState& ms, Block& blk, const std::vector<std::shared_ptr<Value>>& regs, const Instruction& in) const {
+    for (auto r : mSnapshots.at(in.snapshot)) {
+        ms.stack().push(regs[r]);
+    }
+    return blk.run(ms, in.source);
+}
+
+Operation::Result RegisterProgram::execute(MachineState& ms, Block& blk) const {
+    std::vector<std::shared_ptr<Value>> regs(mRegisters);
+    size_t pc = 0;
+    while (pc < size()) {
+        const auto& in = mInstructions[pc];
+        switch (in.opcode) {
+            case Opcode::ARGS:
+                if (!ms.stack().hasAtLeast(in.count)) return deoptimize(ms, blk, regs, in);
+                regs[in.a] = ms.stack().pop();
+                if (in.count > 1) regs[in.b] = ms.stack().pop();
+                break;
+            case Opcode::FLUSH:
+                for (auto r : mSnapshots[in.snapshot]) {
+                    ms.stack().push(regs[r]);
+                }
+                break;
+            case Opcode::BINARY: {
+                auto res = evalBinary(in, regs[in.a], regs[in.b]);
+                if (res == nullptr || res->isOfClass<Value_Error>()) return deoptimize(ms, blk, regs, in);
+                regs[in.dst] = res;
+                break;
+            }
+            case Opcode::UNARY: {
+                auto res = evalUnary(in, regs[in.a]);
+                if (res == nullptr || res->isOfClass<Value_Error>()) return deoptimize(ms, blk, regs, in);
+                regs[in.dst] = res;
+                break;
+            }
+            case Opcode::LOADSLOT: {
+                auto slot = ms.currentSlot();
+                auto res = slot ? slot->find(in.key) : nullptr;
+                if (res == nullptr) return deoptimize(ms, blk, regs, in);
+                regs[in.dst] = res;
+                break;
+            }
+            case Opcode::OPERATION: {
+                ms.onExecutingOperation(in.source);
+                auto res = in.operation->execute(ms);
+                switch (res) {
+                    case Operation::Result::HALT: return res;
+                    case Operation::Result::AGAIN: continue;
+                    case Operation::Result::ERROR: return res;
+                    case Operation::Result::EXIT_BLOCK: return Operation::Result::SUCCESS;
+                    case Operation::Result::RESTART_BLOCK: pc = 0; continue;
+                    case Operation::Result::SUCCESS: break;
+                }
+                break;
+            }
+        }
+        ++pc;
+    }
+
+    return Operation::Result::SUCCESS;
+}
+
+std::string RegisterProgram::describe() const {
+    IndentingStream is;
+    bool first = true;
+    auto line = [&is, &first] () -> void {
+        if (!first) is.append("\n");
+        first = false;
+    };
+    for (size_t i = 0; i < mRegisters.size(); ++i) {
+        if (mRegisters[i] == nullptr) continue;
+        line();
+        is.append("r%u := %s", (unsigned)i, mRegisters[i]->describe().c_str());
+    }
+    for (const auto& in : mInstructions) {
+        line();
+        switch (in.opcode) {
+            case Opcode::ARGS:
+                if (in.count > 1) is.append("args r%u, r%u", in.a, in.b);
+                else is.append("args r%u", in.a);
+                break;
+            case Opcode::FLUSH: {
+                is.append("flush");
+                bool firstreg = true;
+                for (auto r : mSnapshots[in.snapshot]) {
+                    is.append(firstreg ? " r%u" : ", r%u", r);
+                    firstreg = false;
+                }
+                break;
+            }
+            case Opcode::BINARY:
+                is.append("r%u = %s r%u, r%u", in.dst, operationTypeToString(in.type).c_str(), in.a, in.b);
+                break;
+            case Opcode::UNARY:
+                is.append("r%u = %s r%u", in.dst, operationTypeToString(in.type).c_str(), in.a);
+                break;
+            case Opcode::LOADSLOT:
+                is.append("r%u = loadslot %s", in.dst, in.key->describe().c_str());
+                break;
+            case Opcode::OPERATION:
+                is.append("%s", in.operation->describe().c_str());
+                break;
+        }
+    }
+    return is.str();
+}
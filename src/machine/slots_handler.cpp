@@ -13,11 +13,14 @@
 // limitations under the License.
 
 #include <machine/slots_handler.h>
+#include <value/value_table.h>
 
 SlotsHandler::SlotsHandler(MachineState& ms) : MachineEventsListener(ms) {}
 
 void SlotsHandler::onEnteringBlock(std::shared_ptr<Block> blk) {
-    getMachineState().pushSlot((blk->newSlot(), blk));
+    // forks run concurrently with other machines and must not touch the Block's own slots
+    if (getMachineState().isFork()) getMachineState().pushSlot(std::make_shared<ValueTable>());
+    else getMachineState().pushSlot((blk->newSlot(), blk));
     blk->loadSlots(getMachineState());
 }
 void SlotsHandler::onLeavingBlock() {
@@ -21,16 +21,30 @@
 #include <machine/slots_handler.h>
 #include <value/operation.h>
 #include <stream/indenting_stream.h>
+#include <machine/worker_pool.h>
+#include <value/hash_cons.h>
 
-MachineState::MachineState() : mNativeOperations(*this) {
+MachineState::MachineState() : mNativeOperations(*this), mRegisterExecution(false), mHashConsing(false), mPipelineFusion(false), mParent(nullptr), mParallelThreshold(DEFAULT_PARALLEL_THRESHOLD) {
     appendListener(std::make_shared<SlotsHandler>(*this));
 }
 
+MachineState::MachineState(MachineState* parent) : mNativeOperations(*this),
+                                                   mRegisterExecution(parent->mRegisterExecution),
+                                                   mHashConsing(parent->mHashConsing),
+                                                   mPipelineFusion(parent->mPipelineFusion),
+                                                   mParent(parent->mParent ? parent->mParent : parent),
+                                                   mWorkerPool(parent->mWorkerPool),
+                                                   mParallelThreshold(parent->mParallelThreshold) {
+    appendListener(std::make_shared<SlotsHandler>(*this));
+    if (auto slot = parent->currentSlot()) pushSlot(slot);
+}
+
 Stack& MachineState::stack() {
     return mStack;
 }
 
 ValueStore& MachineState::value_store() {
+    if (mParent) return mParent->value_store();
     return mValueStore;
 }
 
@@ -38,11 +52,12 @@ NativeOperations& MachineState::native_operations() {
     return mNativeOperations;
 }
 
-bool MachineState::loadOneValue(ByteStream* bs) {
+bool MachineState::loadOneValue(ByteStream* bs, HashCons* hc) {
     auto rname = bs->readIdentifier();
     if (!rname) return false;
 
     if (auto val = Value::fromByteStream(bs)) {
+        if (hc) val = hc->intern(val);
         value_store().store(rname.value(), val);
         return true;
     }
@@ -50,10 +65,11 @@ bool MachineState::loadOneValue(ByteStream* bs) {
     return false;
 }
 
-bool MachineState::loadOneValue(Parser* p) {
+bool MachineState::loadOneValue(Parser* p, HashCons* hc) {
     auto val = p->parseValue();
     if (val == nullptr) return false;
 
+    if (hc) val->value = hc->intern(val->value);
     value_store().store(val->name, val->value);
     return true;
 }
@@ -62,8 +78,9 @@ size_t MachineState::load(ByteStream* bs) {
     auto ver = bs->readNumber(1);
     if (ver.value_or(0) != FORMAT_VERSION) return 0;
 
+    HashCons hc;
     size_t n = 0;
-    while(loadOneValue(bs)) ++n;
+    while(loadOneValue(bs, mHashConsing ? &hc : nullptr)) ++n;
     return n;
 }
 
@@ -73,8 +90,9 @@ size_t MachineState::serialize(Serializer* s) {
 }
 
 size_t MachineState::load(Parser* p) {
+    HashCons hc;
     size_t n = 0;
-    while(loadOneValue(p)) ++n;
+    while(loadOneValue(p, mHashConsing ? &hc : nullptr)) ++n;
     return n;
 }
 
@@ -120,6 +138,9 @@ std::optional<Operation::Result> MachineState::execute(const std::string& name)
 void MachineState::pushSlot(std::shared_ptr<Block> blk) {
     mSlots.push(blk->currentSlot());
 }
+void MachineState::pushSlot(std::shared_ptr<ValueTable> slot) {
+    mSlots.push(slot);
+}
 void MachineState::popSlot() {
     if (!mSlots.empty()) mSlots.pop();
 }
@@ -131,3 +152,46 @@ std::shared_ptr<ValueTable> MachineState::currentSlot() const {
 bool MachineState::loadNativeLibrary(std::string name) {
     return native_operations().loadNativeLibrary(name);
 }
+
+bool MachineState::registerExecution() const {
+    return mRegisterExecution;
+}
+void MachineState::setRegisterExecution(bool r) {
+    mRegisterExecution = r;
+}
+
+bool MachineState::hashConsing() const {
+    return mHashConsing;
+}
+void MachineState::setHashConsing(bool h) {
+    mHashConsing = h;
+}
+
+bool MachineState::pipelineFusion() const {
+    return mPipelineFusion;
+}
+void MachineState::setPipelineFusion(bool p) {
+    mPipelineFusion = p;
+}
+
+bool MachineState::parallelExecution() const {
+    return mWorkerPool != nullptr;
+}
+size_t MachineState::parallelThreshold() const {
+    return mParallelThreshold;
+}
+std::shared_ptr<WorkerPool> MachineState::workerPool() const {
+    return mWorkerPool;
+}
+void MachineState::setParallelExecution(size_t workers, size_t threshold) {
+    if (workers) mWorkerPool = std::make_shared<WorkerPool>(workers);
+    else mWorkerPool.reset();
+    mParallelThreshold = threshold;
+}
+
+std::unique_ptr<MachineState> MachineState::fork() {
+    return std::unique_ptr<MachineState>(new MachineState(this));
+}
+bool MachineState::isFork() const {
+    return mParent != nullptr;
+}
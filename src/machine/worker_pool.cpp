@@ -0,0 +1,56 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <machine/worker_pool.h>
+
+WorkerPool::WorkerPool(size_t n) : mStopping(false) {
+    for (size_t i = 0; i < n; ++i) {
+        mThreads.emplace_back([this] () -> void { work(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::unique_lock<std::mutex> lk(mLock);
+        mStopping = true;
+    }
+    mReady.notify_all();
+    for (auto& t : mThreads) t.join();
+}
+
+size_t WorkerPool::size() const {
+    return mThreads.size();
+}
+
+void WorkerPool::submit(std::function<void()> f) {
+    {
+        std::unique_lock<std::mutex> lk(mLock);
+        mQueue.push_back(f);
+    }
+    mReady.notify_one();
+}
+
+void WorkerPool::work() {
+    while(true) {
+        std::function<void()> f;
+        {
+            std::unique_lock<std::mutex> lk(mLock);
+            mReady.wait(lk, [this] () -> bool { return mStopping || !mQueue.empty(); });
+            if (mQueue.empty()) return;
+            f = mQueue.front();
+            mQueue.pop_front();
+        }
+        f();
+    }
+}
@@ -19,7 +19,9 @@
 Operation::Result Append::doExecute(MachineState& s) {
     auto item = s.stack().pop();
     auto container = s.stack().pop();
-    auto cloned = container->clone();
+    // if only the stack held the container, nobody can observe it changing
+    const bool unique = container.use_count() == 1;
+    auto cloned = unique ? container : container->clone();
 
     if (auto app = Appendable::asAppendable(cloned)) {
         auto ret = app->appendValue(item);
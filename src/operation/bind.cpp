@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <operation/bind.h>
+#include <value/hash_cons.h>
+#include <value/hasher.h>
 #include <stream/indenting_stream.h>
 #include <stream/serializer.h>
 #include <parser/parser.h>
@@ -48,6 +50,15 @@ bool PartialBind::equals(std::shared_ptr<Operation> op) const {
     } else return false;
 }
 
+size_t PartialBind::hash() const {
+    return HashMix::combine(HashMix::combine(Operation::hash(), value()->hash()), callable()->hash());
+}
+
+void PartialBind::hashCons(HashCons& hc) {
+    mValue = hc.intern(mValue);
+    mCallable->hashCons(hc);
+}
+
 std::shared_ptr<PartialBind> PartialBind::fromByteStream(ByteStream* bs) {
     auto val = Value::fromByteStream(bs);
     auto cal = OperationLoader::loader()->fromByteStream(bs);
@@ -71,7 +82,6 @@ size_t PartialBind::serialize(Serializer* s) const {
 }
 
 std::shared_ptr<Operation> PartialBind::clone() const {
-    auto val = value()->clone();
-    auto cal = callable()->clone();
-    return std::make_shared<PartialBind>(val, cal);
+    auto val = value()->isOfClass<Value_Operation>() ? value()->clone() : value();
+    return std::make_shared<PartialBind>(val, callable()->clone());
 }
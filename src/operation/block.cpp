@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <operation/block.h>
+#include <value/hash_cons.h>
+#include <value/hasher.h>
 #include <stream/indenting_stream.h>
 #include <stream/byte_stream.h>
 #include <operation/op_loader.h>
@@ -21,9 +23,16 @@
 #include <rtti/rtti.h>
 #include <value/string.h>
 #include <value/table.h>
+#include <ir/register_program.h>
+#include <ir/parallel_plan.h>
+#include <ir/pipeline_plan.h>
+#include <atomic>
 
 void Block::add(std::shared_ptr<Operation> op) {
     mOperations.push_back(op);
+    std::atomic_store(&mRegisterProgram, std::shared_ptr<RegisterProgram>());
+    std::atomic_store(&mParallelPlan, std::shared_ptr<ParallelPlan>());
+    std::atomic_store(&mPipelinePlan, std::shared_ptr<PipelinePlan>());
 }
 
 size_t Block::size() const {
@@ -45,9 +54,39 @@ decltype(Block::mOperations)::const_iterator Block::end() const {
 
 Operation::Result Block::doExecute(MachineState& ms) {
     ms.onEnteringBlock(std::static_pointer_cast<Block>(shared_from_this()));
-    size_t i = 0;
+    Operation::Result res;
+    if (ms.registerExecution()) res = registerProgram()->execute(ms, *this);
+    else res = run(ms);
+    ms.onLeavingBlock();
+    return res;
+}
+
+Operation::Result Block::run(MachineState& ms, size_t i) {
     Operation::Result res = Operation::Result::SUCCESS;
+    auto plan = parallelPlan(ms);
+    auto pipelines = ms.pipelineFusion() ? pipelinePlan() : nullptr;
     while(i < size()) {
+        if (plan) {
+            if (auto r = plan->regionAt(i, size())) {
+                if (!plan->isCurrent(ms)) {
+                    plan = parallelPlan(ms);
+                    continue;
+                }
+                res = plan->execute(ms, *this, r.value());
+                if (res != Operation::Result::SUCCESS) goto out;
+                i = plan->at(r.value()).end;
+                continue;
+            }
+        }
+        if (pipelines) {
+            if (auto p = pipelines->pipelineAt(i)) {
+                ms.onExecutingOperation(i);
+                res = pipelines->execute(ms, *this, p.value());
+                if (res != Operation::Result::SUCCESS) goto out;
+                i = pipelines->at(p.value()).end;
+                continue;
+            }
+        }
         auto op = at(i);
         ms.onExecutingOperation(i);
         res = op->execute(ms);
@@ -62,10 +101,37 @@ Operation::Result Block::doExecute(MachineState& ms) {
     }
 
 out:
-    ms.onLeavingBlock();
     return res;
 }
 
+std::shared_ptr<RegisterProgram> Block::registerProgram() const {
+    auto prg = std::atomic_load(&mRegisterProgram);
+    if (prg == nullptr) {
+        prg = RegisterProgram::fromBlock(*this);
+        std::atomic_store(&mRegisterProgram, prg);
+    }
+    return prg;
+}
+
+std::shared_ptr<ParallelPlan> Block::parallelPlan(MachineState& ms) const {
+    if (!ms.parallelExecution()) return nullptr;
+    auto plan = std::atomic_load(&mParallelPlan);
+    if (plan == nullptr || !plan->isCurrent(ms)) {
+        plan = ParallelPlan::fromBlock(*this, ms);
+        std::atomic_store(&mParallelPlan, plan);
+    }
+    return plan;
+}
+
+std::shared_ptr<PipelinePlan> Block::pipelinePlan() const {
+    auto plan = std::atomic_load(&mPipelinePlan);
+    if (plan == nullptr) {
+        plan = PipelinePlan::fromBlock(*this);
+        std::atomic_store(&mPipelinePlan, plan);
+    }
+    return plan;
+}
+
 std::string Block::describe() const {
     IndentingStream is;
     is.append("block ");
@@ -183,6 +249,23 @@ bool Block::equals(std::shared_ptr<Operation> rhs) const {
     return false;
 }
 
+size_t Block::hash() const {
+    uint64_t h = HashMix::combine(Operation::hash(), numSlotValues());
+    for (size_t i = 0; i < numSlotValues(); ++i) {
+        h = HashMix::combine(h, HashMix::of(slotValueAt(i).value_or("")));
+    }
+    for (size_t i = 0; i < size(); ++i) {
+        h = HashMix::combine(h, at(i)->hash());
+    }
+    return h;
+}
+
+void Block::hashCons(HashCons& hc) {
+    for (size_t i = 0; i < size(); ++i) {
+        at(i)->hashCons(hc);
+    }
+}
+
 std::shared_ptr<ValueTable> Block::newSlot() {
     auto vt = std::make_shared<ValueTable>();
     mSlots.push_back(vt);
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <operation/call.h>
+#include <value/hash_cons.h>
+#include <value/hasher.h>
 #include <machine/state.h>
 #include <stream/indenting_stream.h>
 #include <rtti/rtti.h>
@@ -47,9 +49,16 @@ bool Call::equals(std::shared_ptr<Operation> op) const {
     return false;
 }
 
+size_t Call::hash() const {
+    return HashMix::combine(HashMix::combine(Operation::hash(), HashMix::of(name())), arguments()->hash());
+}
+
+void Call::hashCons(HashCons& hc) {
+    mArguments = hc.intern(mArguments);
+}
+
 std::shared_ptr<Operation> Call::clone() const {
-    return std::make_shared<Call>(name(),
-                                  std::dynamic_pointer_cast<Value_Tuple>(arguments()->clone()));
+    return std::make_shared<Call>(name(), arguments());
 }
 
 Operation::Result Call::doExecute(MachineState& ms) {
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <operation/clear.h>
+#include <value/hasher.h>
 #include <value/value_store.h>
 #include <value/value.h>
 #include <stream/indenting_stream.h>
@@ -76,6 +77,10 @@ bool Clear::equals(std::shared_ptr<Operation> rhs) const {
     return false;
 }
 
+size_t Clear::hash() const {
+    return HashMix::combine(Operation::hash(), HashMix::of(key()));
+}
+
 std::shared_ptr<Operation> Clear::clone() const {
     return std::make_shared<Clear>(key());
 }
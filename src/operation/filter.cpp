@@ -18,7 +18,9 @@
 #include <value/boolean.h>
 #include <value/appendable.h>
 #include <value/iterable.h>
+#include <value/tuple.h>
 #include <machine/state.h>
+#include <optional>
 
 Operation::Result Filter::doExecute(MachineState& s) {
     auto vpred = s.stack().pop();
@@ -42,7 +44,9 @@ Operation::Result Filter::doExecute(MachineState& s) {
         return Operation::Result::ERROR;
     }
 
-    auto newval = Appendable::asAppendable(iter->asValue())->newEmptyOfSameType();
+    // containers that cannot be appended to, like ranges, produce a tuple
+    auto srcapp = Appendable::asAppendable(vcnt);
+    auto newval = srcapp ? srcapp->newEmptyOfSameType() : Value::tuple({});
     auto newapp = Appendable::asAppendable(newval);
 
     if (newapp == nullptr) {
@@ -52,23 +56,27 @@ Operation::Result Filter::doExecute(MachineState& s) {
         return Operation::Result::ERROR;
     }
 
-    for(size_t i = 0; i < iter->size(); ++i) {
-        auto itm = iter->at(i);
+    std::optional<ErrorCode> err;
+    iter->forEach([&] (const std::shared_ptr<Value>& itm) -> bool {
         s.stack().push(itm);
-        auto ok = cbk->execute(s);
-        if (ok != Operation::Result::SUCCESS) {
-            s.stack().push(vcnt);
-            s.stack().push(vpred);
-            s.stack().push(Value::error(ErrorCode::UNEXPECTED_RESULT));
-            return Operation::Result::ERROR;
+        if (cbk->execute(s) != Operation::Result::SUCCESS) {
+            err = ErrorCode::UNEXPECTED_RESULT;
+            return false;
         }
         auto res = runtime_ptr_cast<Value_Boolean>(s.stack().pop());
         if (res == nullptr) {
-            s.stack().push(vcnt);
-            s.stack().push(vpred);
-            s.stack().push(Value::error(ErrorCode::TYPE_MISMATCH));
-            return Operation::Result::ERROR;
-        } else if (res->value()) newapp->appendValue(itm);
+            err = ErrorCode::TYPE_MISMATCH;
+            return false;
+        }
+        if (res->value()) newapp->appendValue(itm);
+        return true;
+    });
+
+    if (err) {
+        s.stack().push(vcnt);
+        s.stack().push(vpred);
+        s.stack().push(Value::error(*err));
+        return Operation::Result::ERROR;
     }
 
     s.stack().push(newval);
@@ -18,11 +18,22 @@
 #include <value/boolean.h>
 #include <value/findable.h>
 #include <value/error.h>
+#include <value/table.h>
 
 Operation::Result Find::doExecute(MachineState& s) {
     auto key = s.stack().pop();
     auto obj = s.stack().pop();
 
+    auto tbl = runtime_ptr_cast<Value_Table>(obj);
+    if (tbl && key) {
+        auto val = tbl->retrieve(key, mCache);
+
+        if (val == nullptr) s.stack().push(Value::error(ErrorCode::NOT_FOUND));
+        else s.stack().push(val);
+
+        return Operation::Result::SUCCESS;
+    }
+
     auto fnd = FindableValue::asFindable(obj);
 
     if (fnd && key) {
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <operation/iftrue.h>
+#include <value/hash_cons.h>
 #include <value/boolean.h>
 #include <value/value.h>
 #include <rtti/rtti.h>
@@ -79,3 +80,7 @@ std::shared_ptr<Operation> IfTrue::op() const {
 std::shared_ptr<Operation> IfTrue::clone() const {
     return std::make_shared<IfTrue>(op()->clone());
 }
+
+void IfTrue::hashCons(HashCons& hc) {
+    mOperation->hashCons(hc);
+}
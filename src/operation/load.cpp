@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <operation/load.h>
+#include <value/hasher.h>
 #include <value/value_store.h>
 #include <value/value.h>
 #include <stream/indenting_stream.h>
@@ -75,6 +76,10 @@ bool Load::equals(std::shared_ptr<Operation> rhs) const {
     return false;
 }
 
+size_t Load::hash() const {
+    return HashMix::combine(Operation::hash(), HashMix::of(key()));
+}
+
 std::shared_ptr<Operation> Load::clone() const {
     return std::make_shared<Load>(key());
 }
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <operation/loadnative.h>
+#include <value/hasher.h>
 #include <stream/indenting_stream.h>
 #include <stream/serializer.h>
 #include <parser/parser.h>
@@ -70,6 +71,10 @@ bool Loadnative::equals(std::shared_ptr<Operation> rhs) const {
     return false;
 }
 
+size_t Loadnative::hash() const {
+    return HashMix::combine(Operation::hash(), HashMix::of(key()));
+}
+
 std::shared_ptr<Operation> Loadnative::clone() const {
     return std::make_shared<Loadnative>(key());
 }
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <operation/loadslot.h>
+#include <value/hasher.h>
 #include <value/value.h>
 #include <stream/indenting_stream.h>
 #include <error/error_codes.h>
@@ -77,6 +78,10 @@ bool Loadslot::equals(std::shared_ptr<Operation> rhs) const {
     return false;
 }
 
+size_t Loadslot::hash() const {
+    return HashMix::combine(Operation::hash(), HashMix::of(key()));
+}
+
 std::shared_ptr<Operation> Loadslot::clone() const {
     return std::make_shared<Loadslot>(key());
 }
@@ -19,6 +19,9 @@
 #include <value/appendable.h>
 #include <value/iterable.h>
 #include <error/error_codes.h>
+#include <operation/numeric_callback.h>
+#include <value/tuple.h>
+#include <optional>
 
 Operation::Result Map::doExecute(MachineState& s) {
     auto vpred = s.stack().pop();
@@ -42,7 +45,19 @@ Operation::Result Map::doExecute(MachineState& s) {
         return Operation::Result::ERROR;
     }
 
-    auto newval = Appendable::asAppendable(iter->asValue())->newEmptyOfSameType();
+    if (auto tpl = vcnt->asClass<Value_Tuple>()) {
+        auto numeric = NumericCallback::fromOperation(cbk->value());
+        if (numeric && numeric->bound) {
+            if (auto mapped = tpl->values().mapNumbers(numeric->operation, *numeric->bound)) {
+                s.stack().push(std::make_shared<Value_Tuple>(*mapped));
+                return Operation::Result::SUCCESS;
+            }
+        }
+    }
+
+    // containers that cannot be appended to, like ranges, produce a tuple
+    auto srcapp = Appendable::asAppendable(vcnt);
+    auto newval = srcapp ? srcapp->newEmptyOfSameType() : Value::tuple({});
     auto newapp = Appendable::asAppendable(newval);
 
     if (newapp == nullptr) {
@@ -52,24 +67,26 @@ Operation::Result Map::doExecute(MachineState& s) {
         return Operation::Result::ERROR;
     }
 
-    for(size_t i = 0; i < iter->size(); ++i) {
-        auto itm = iter->at(i);
+    std::optional<ErrorCode> err;
+    iter->forEach([&] (const std::shared_ptr<Value>& itm) -> bool {
         s.stack().push(itm);
-        auto ok = cbk->execute(s);
-        if (ok != Operation::Result::SUCCESS) {
-            s.stack().push(vcnt);
-            s.stack().push(vpred);
-            s.stack().push(Value::error(ErrorCode::UNEXPECTED_RESULT));
-            return Operation::Result::ERROR;
-        } else {
-            auto ok = newapp->appendValue(s.stack().pop());
-            if (auto err = std::get_if<ErrorCode>(&ok)) {
-                s.stack().push(vcnt);
-                s.stack().push(vpred);
-                s.stack().push(Value::error(*err));
-                return Operation::Result::ERROR;
-            }
+        if (cbk->execute(s) != Operation::Result::SUCCESS) {
+            err = ErrorCode::UNEXPECTED_RESULT;
+            return false;
         }
+        auto ok = newapp->appendValue(s.stack().pop());
+        if (auto e = std::get_if<ErrorCode>(&ok)) {
+            err = *e;
+            return false;
+        }
+        return true;
+    });
+
+    if (err) {
+        s.stack().push(vcnt);
+        s.stack().push(vpred);
+        s.stack().push(Value::error(*err));
+        return Operation::Result::ERROR;
     }
 
     s.stack().push(newval);
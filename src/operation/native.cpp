@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <operation/native.h>
+#include <value/hasher.h>
 #include <stream/indenting_stream.h>
 #include <stream/byte_stream.h>
 #include <parser/parser.h>
@@ -48,6 +49,10 @@ bool Native::equals(std::shared_ptr<Operation> op) const {
     return false;
 }
 
+size_t Native::hash() const {
+    return HashMix::combine(Operation::hash(), HashMix::of(fullyQualifiedName()));
+}
+
 std::string Native::name() const {
     return mName;
 }
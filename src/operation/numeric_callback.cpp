@@ -0,0 +1,59 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <operation/numeric_callback.h>
+#include <operation/block.h>
+#include <operation/bind.h>
+#include <operation/push.h>
+#include <value/number.h>
+#include <rtti/rtti.h>
+
+namespace {
+    bool isBinaryArithmetic(OperationType type) {
+        switch (type) {
+            case OperationType::ADD:
+            case OperationType::SUBTRACT:
+            case OperationType::MULTIPLY:
+            case OperationType::DIVIDE:
+            case OperationType::MODULO:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    std::optional<NumericCallback> bindNumber(const std::shared_ptr<Value>& val, const std::shared_ptr<Operation>& op) {
+        auto num = val->asClass<Value_Number>();
+        if (num == nullptr || !isBinaryArithmetic(op->getClassId())) return std::nullopt;
+        return NumericCallback{op->getClassId(), num->value()};
+    }
+}
+
+std::optional<NumericCallback> NumericCallback::fromOperation(const std::shared_ptr<Operation>& op) {
+    if (isBinaryArithmetic(op->getClassId())) return NumericCallback{op->getClassId(), std::nullopt};
+
+    if (auto bind = op->asClass<PartialBind>()) {
+        return bindNumber(bind->value(), bind->callable());
+    }
+
+    if (auto blk = op->asClass<Block>()) {
+        if (blk->numSlotValues() != 0) return std::nullopt;
+        if (blk->size() == 1) return fromOperation(blk->at(0));
+        if (blk->size() == 2) {
+            if (auto push = blk->at(0)->asClass<Push>()) return bindNumber(push->value(), blk->at(1));
+        }
+    }
+
+    return std::nullopt;
+}
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <operation/op.h>
+#include <value/hasher.h>
 #include <stream/serializer.h>
 #include <machine/state.h>
 #include <rtti/enum.h>
@@ -32,6 +33,12 @@ bool Operation::equals(std::shared_ptr<Operation> rhs) const {
     return getClassId() == rhs->getClassId();
 }
 
+size_t Operation::hash() const {
+    return HashMix::of(enumToNumber(getClassId()));
+}
+
+void Operation::hashCons(HashCons&) {}
+
 std::string operationResultToString(Operation::Result r) {
     switch (r) {
         case Operation::Result::ERROR: return "error";
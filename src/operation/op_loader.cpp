@@ -27,18 +27,9 @@ OperationLoader* OperationLoader::loader() {
 OperationLoader::OperationLoader() = default;
 OperationLoader::~OperationLoader() = default;
 
-void OperationLoader::addLoader(OperationType op, LoaderFunction f) {
-    mLoaders.emplace(op, f);
-}
-
-void OperationLoader::addParser(OperationType op, ParserFunction f) {
-    mParsers.emplace(op, f);
-}
-
 std::shared_ptr<Operation> OperationLoader::fromByteStream(ByteStream* bs) {
     if (auto ot = operationTypeFromByteStream(bs)) {
-        auto iter = mLoaders.find(ot.value()), end = mLoaders.end();
-        if (iter != end) return iter->second(bs);
+        if (auto e = entry(ot.value())) return e->loader(bs);
     }
 
     return nullptr;
@@ -49,10 +40,7 @@ std::shared_ptr<Operation> OperationLoader::fromParser(Parser* p) {
     auto id = p->expectedError(TokenKind::IDENTIFIER);
     if (id == std::nullopt) return nullptr;
     if (auto ot = operationTypeFromString(id->value())) {
-        auto iter = mParsers.find(ot.value()), end = mParsers.end();
-        if (iter != end) {
-            op = iter->second(p);
-        }
+        if (auto e = entry(ot.value())) op = e->parser(p);
     }
     if (op) return op;
     else {
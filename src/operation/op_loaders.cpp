@@ -52,14 +52,36 @@
 #include <operation/typecast.h>
 #include <operation/typeof.h>
 #include <operation/unpack.h>
+#include <operation/view.h>
 
+#include <rtti/enum.h>
+#include <array>
+
+namespace {
+    template<typename T>
+    std::shared_ptr<Operation> loadOperation(ByteStream* bs) {
+        return T::fromByteStream(bs);
+    }
+    template<typename T>
+    std::shared_ptr<Operation> parseOperation(Parser* p) {
+        return T::fromParser(p);
+    }
+
+    using Table = std::array<OperationLoader::Entry, enumToNumber(std::numeric_limits<OperationType>::max()) + 1>;
+
+    constexpr Table makeTable() {
+        Table t{};
 #define OPERATION_TYPE(NAME, CLASS, TOKEN, STRING, NUMBER) \
-void OpLoader ## CLASS () { \
-            OperationLoader::loader()->addLoader(OperationType:: NAME, [] (ByteStream* bs) -> std::shared_ptr<Operation> { \
-                return CLASS ::fromByteStream(bs); \
-            }); \
-            OperationLoader::loader()->addParser(OperationType:: NAME, [] (Parser* p) -> std::shared_ptr<Operation> { \
-                return CLASS ::fromParser(p); \
-            }); \
-}
+        t[NUMBER] = OperationLoader::Entry{&loadOperation<CLASS>, &parseOperation<CLASS>};
 #include <operation/op_types.def>
+        return t;
+    }
+
+    constexpr Table gLoaders = makeTable();
+}
+
+const OperationLoader::Entry* OperationLoader::entry(OperationType op) {
+    auto n = enumToNumber(op);
+    if (n >= gLoaders.size() || gLoaders[n].loader == nullptr) return nullptr;
+    return &gLoaders[n];
+}
@@ -14,6 +14,7 @@
 
 #include <operation/op_types.h>
 #include <stream/byte_stream.h>
+#include <parser/perfect_hash.h>
 
 #define OPERATION_TYPE(ID, CLASS, TOKEN, STRING, NUMBER) \
     case OperationType:: ID: { static_assert(NUMBER <= enumToNumber(std::numeric_limits<OperationType>::max())); return STRING; };
@@ -37,10 +38,20 @@ std::optional<OperationType> operationTypeFromByteStream(ByteStream* bs) {
 }
 
 
-#define OPERATION_TYPE(NAME, CLASS, TOKEN, STRING, VALUE) \
-    if (s == #TOKEN) return OperationType:: NAME;
+namespace {
+    constexpr size_t NUM_OPERATION_TYPES = 0
+#define OPERATION_TYPE(NAME, CLASS, TOKEN, STRING, VALUE) + 1
+#include <operation/op_types.def>
+    ;
 
-std::optional<OperationType> operationTypeFromString(const std::string& s) {
+    using Keywords = PerfectHash<OperationType, NUM_OPERATION_TYPES, 256>;
+
+    constexpr Keywords gKeywords(std::array<Keywords::Entry, NUM_OPERATION_TYPES>{{
+#define OPERATION_TYPE(NAME, CLASS, TOKEN, STRING, VALUE) Keywords::Entry{#TOKEN, OperationType:: NAME},
 #include <operation/op_types.def>
-    return std::nullopt;
+    }});
+}
+
+std::optional<OperationType> operationTypeFromString(const std::string& s) {
+    return gKeywords.find(s);
 }
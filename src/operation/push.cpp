@@ -13,11 +13,14 @@
 // limitations under the License.
 
 #include <operation/push.h>
+#include <value/hash_cons.h>
+#include <value/hasher.h>
 #include <stream/indenting_stream.h>
 #include <stream/serializer.h>
 #include <parser/parser.h>
 #include <rtti/rtti.h>
 #include <machine/state.h>
+#include <value/operation.h>
 
 Push::Push(std::shared_ptr<Value> v) : mValue(v) {}
 
@@ -66,7 +69,17 @@ bool Push::equals(std::shared_ptr<Operation> rhs) const {
     return false;
 }
 
+size_t Push::hash() const {
+    return HashMix::combine(Operation::hash(), value()->hash());
+}
+
+void Push::hashCons(HashCons& hc) {
+    mValue = hc.intern(mValue);
+}
+
 std::shared_ptr<Operation> Push::clone() const {
-    return std::make_shared<Push>(value()->clone());
+    // only operation values carry per-instance state, so any other value is shared
+    auto val = value()->isOfClass<Value_Operation>() ? value()->clone() : value();
+    return std::make_shared<Push>(val);
 }
 
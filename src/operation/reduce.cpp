@@ -17,6 +17,9 @@
 #include <value/iterable.h>
 #include <value/operation.h>
 #include <machine/state.h>
+#include <operation/numeric_callback.h>
+#include <value/tuple.h>
+#include <value/number.h>
 
 Operation::Result Reduce::doExecute(MachineState& s) {
     auto v0 = s.stack().pop();
@@ -44,18 +47,32 @@ Operation::Result Reduce::doExecute(MachineState& s) {
         return Operation::Result::ERROR;
     }
 
-    for(size_t i = 0; i < iter->size(); ++i) {
-        auto itm = iter->at(i);
+    auto tpl = vcnt->asClass<Value_Tuple>();
+    auto initial = v0->asClass<Value_Number>();
+    if (tpl && initial) {
+        auto numeric = NumericCallback::fromOperation(cbk->value());
+        if (numeric && !numeric->bound) {
+            if (auto reduced = tpl->values().reduceNumbers(numeric->operation, initial->value())) {
+                s.stack().push(Value::fromNumber(*reduced));
+                return Operation::Result::SUCCESS;
+            }
+        }
+    }
+
+    bool ok = iter->forEach([&] (const std::shared_ptr<Value>& itm) -> bool {
         s.stack().push(itm);
         s.stack().push(v0);
-        auto ok = cbk->execute(s);
-        if (ok != Operation::Result::SUCCESS) {
-            s.stack().push(vcnt);
-            s.stack().push(vpred);
-            s.stack().push(v0_0);
-            s.stack().push(Value::error(ErrorCode::UNEXPECTED_RESULT));
-            return Operation::Result::ERROR;
-        } else v0 = s.stack().pop();
+        if (cbk->execute(s) != Operation::Result::SUCCESS) return false;
+        v0 = s.stack().pop();
+        return true;
+    });
+
+    if (!ok) {
+        s.stack().push(vcnt);
+        s.stack().push(vpred);
+        s.stack().push(v0_0);
+        s.stack().push(Value::error(ErrorCode::UNEXPECTED_RESULT));
+        return Operation::Result::ERROR;
     }
 
     s.stack().push(v0);
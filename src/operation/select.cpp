@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <operation/select.h>
+#include <value/hash_cons.h>
+#include <value/hasher.h>
 #include <value/table.h>
 #include <value/operation.h>
 #include <operation/nop.h>
@@ -59,12 +61,26 @@ bool Select::equals(std::shared_ptr<Operation> op) const {
     return false;
 }
 
+size_t Select::hash() const {
+    return HashMix::combine(HashMix::combine(Operation::hash(), mCases->hash()), mDefault ? mDefault->hash() : 0);
+}
+
+void Select::hashCons(HashCons& hc) {
+    mCases = hc.intern(mCases);
+    if (mDefault) mDefault->value()->hashCons(hc);
+}
+
 std::shared_ptr<Operation> Select::clone() const {
+    ValueTable cases;
+    mCases->forEachEntry(0, mCases->size(), [&cases] (const std::shared_ptr<Value>& k, const std::shared_ptr<Value>& v) {
+        cases.add(k, v->clone());
+        return true;
+    });
     if (mDefault == nullptr) {
-        return std::make_shared<Select>(std::dynamic_pointer_cast<Value_Table>(cases()->clone()));
+        return std::make_shared<Select>(std::make_shared<Value_Table>(cases));
     } else {
         return std::make_shared<Select>(
-            std::dynamic_pointer_cast<Value_Table>(cases()->clone()),
+            std::make_shared<Value_Table>(cases),
             std::dynamic_pointer_cast<Value_Operation>(orElse()->clone()));
     }
 }
@@ -20,6 +20,8 @@
 #include <machine/state.h>
 #include <value/number.h>
 #include <value/set.h>
+#include <value/range.h>
+#include <value/view.h>
 
 Operation::Result Size::doExecute(MachineState& s) {
     auto value = s.stack().pop();
@@ -27,14 +29,20 @@ Operation::Result Size::doExecute(MachineState& s) {
     auto str = runtime_ptr_cast<Value_String>(value);
     auto tbl = runtime_ptr_cast<Value_Table>(value);
     auto set = runtime_ptr_cast<Value_Set>(value);
+    auto rng = runtime_ptr_cast<Value_Range>(value);
+    auto vw = runtime_ptr_cast<Value_View>(value);
     if (tpl) {
         s.stack().push(Value::fromNumber(tpl->size()));
     } else if (str) {
-        s.stack().push(Value::fromNumber(str->value().size()));
+        s.stack().push(Value::fromNumber(str->size()));
     } else if (tbl) {
         s.stack().push(Value::fromNumber(tbl->size()));
     } else if (set) {
         s.stack().push(Value::fromNumber(set->size()));
+    } else if (rng) {
+        s.stack().push(Value::fromNumber(rng->size()));
+    } else if (vw) {
+        s.stack().push(Value::fromNumber(vw->size()));
     } else {
         s.stack().push(Value::fromNumber(1));
     }
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <operation/storeslot.h>
+#include <value/hasher.h>
 #include <stream/indenting_stream.h>
 #include <error/error_codes.h>
 #include <stream/serializer.h>
@@ -75,6 +76,10 @@ bool Storeslot::equals(std::shared_ptr<Operation> rhs) const {
     return false;
 }
 
+size_t Storeslot::hash() const {
+    return HashMix::combine(Operation::hash(), HashMix::of(key()));
+}
+
 std::shared_ptr<Operation> Storeslot::clone() const {
     return std::make_shared<Storeslot>(key());
 }
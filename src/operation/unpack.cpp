@@ -15,21 +15,28 @@
 #include <operation/unpack.h>
 #include <value/number.h>
 #include <value/tuple.h>
+#include <value/range.h>
+#include <value/view.h>
+#include <value/iterable.h>
 #include <rtti/rtti.h>
 #include <machine/state.h>
 
 Operation::Result Unpack::doExecute(MachineState& ms) {
     auto val_tpl = ms.stack().pop();
-    auto tpl = runtime_ptr_cast<Value_Tuple>(val_tpl);
+    std::shared_ptr<IterableValue> tpl;
+    if (val_tpl->isOfClass<Value_Tuple>() || val_tpl->isOfClass<Value_Range>() || val_tpl->isOfClass<Value_View>()) {
+        tpl = IterableValue::asIterable(val_tpl);
+    }
     if (tpl == nullptr) {
         ms.stack().push(val_tpl);
         ms.stack().push(Value::error(ErrorCode::TYPE_MISMATCH));
         return Operation::Result::ERROR;
     }
 
-    for(size_t i = 0; i < tpl->size(); ++i) {
-        ms.stack().push(tpl->at(i));
-    }
+    tpl->forEachChunk([&ms] (const std::shared_ptr<Value>* p, size_t n) -> bool {
+        for (size_t i = 0; i < n; ++i) ms.stack().push(p[i]);
+        return true;
+    });
 
     return Operation::Result::SUCCESS;
 }
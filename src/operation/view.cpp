@@ -0,0 +1,69 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <operation/view.h>
+#include <rtti/rtti.h>
+#include <value/view.h>
+#include <value/table.h>
+#include <value/number.h>
+#include <value/iterable.h>
+#include <machine/state.h>
+
+Operation::Result Slice::doExecute(MachineState& s) {
+    auto vend = s.stack().pop();
+    auto vbegin = s.stack().pop();
+    auto obj = s.stack().pop();
+
+    auto begin = runtime_ptr_cast<Value_Number>(vbegin);
+    auto end = runtime_ptr_cast<Value_Number>(vend);
+    auto iter = IterableValue::asIterable(obj);
+
+    ErrorCode err = ErrorCode::TYPE_MISMATCH;
+    if (begin && end && iter) {
+        if (auto vw = Value_View::slice(obj, begin->value(), end->value())) {
+            s.stack().push(vw);
+            return Operation::Result::SUCCESS;
+        }
+        err = ErrorCode::OUT_OF_BOUNDS;
+    }
+
+    s.stack().push(obj);
+    s.stack().push(vbegin);
+    s.stack().push(vend);
+    s.stack().push(Value::error(err));
+    return Operation::Result::ERROR;
+}
+
+namespace {
+    template<typename F>
+    Operation::Result project(MachineState& s, F&& f) {
+        auto obj = s.stack().pop();
+        auto tbl = runtime_ptr_cast<Value_Table>(obj);
+        if (tbl == nullptr) {
+            s.stack().push(obj);
+            s.stack().push(Value::error(ErrorCode::TYPE_MISMATCH));
+            return Operation::Result::ERROR;
+        }
+        s.stack().push(f(std::static_pointer_cast<Value_Table>(obj)));
+        return Operation::Result::SUCCESS;
+    }
+}
+
+Operation::Result Keys::doExecute(MachineState& s) {
+    return project(s, Value_View::keys);
+}
+
+Operation::Result Values::doExecute(MachineState& s) {
+    return project(s, Value_View::values);
+}
@@ -25,6 +25,7 @@ ByteStream::ByteStream(const uint8_t* data, size_t sz) {
     mBasePointer = (uint8_t*)mmap(nullptr, sz, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_POPULATE, mFd = -1, 0);
     if (mBasePointer != MAP_FAILED) {
         memcpy(mBasePointer, data, mSize = sz);
+        mMapping.reset(mBasePointer, [sz] (uint8_t* p) { munmap(p, sz); });
     } else {
         mBasePointer = nullptr;
         mSize = 0;
@@ -37,6 +38,7 @@ ByteStream::ByteStream(int fd, size_t sz) {
     mBasePointer = (uint8_t*)mmap(nullptr, sz, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_POPULATE, mFd = fd, 0);
     if (mBasePointer != MAP_FAILED) {
         mSize = sz;
+        mMapping.reset(mBasePointer, [sz] (uint8_t* p) { munmap(p, sz); });
     } else {
         mBasePointer = nullptr;
         mSize = 0;
@@ -181,6 +183,11 @@ std::optional<std::string> ByteStream::readIdentifier(char marker) {
 }
 
 std::optional<std::string> ByteStream::readData() {
+    if (auto sl = readSlice()) return std::string(sl->data.get(), sl->size);
+    return std::nullopt;
+}
+
+std::optional<ByteStream::Slice> ByteStream::readSlice() {
     if (eof()) return std::nullopt;
 
     auto on = readNumber();
@@ -188,14 +195,10 @@ std::optional<std::string> ByteStream::readData() {
     size_t n = on.value();
     if (!hasAtLeast(n)) return std::nullopt;
 
-    std::stringstream ss;
-    for(size_t i = 0; i < n; ++i) {
-        auto b = next();
-        if (b == std::nullopt) return std::nullopt;
-        ss << (char)b.value();
-    }
+    const size_t start = peekOffset();
+    if (n > 0) mOffset = start + n - 1;
 
-    return ss.str();
+    return Slice{std::shared_ptr<const char>(mMapping, (const char*)mBasePointer + start), n};
 }
 
 std::optional<bool> ByteStream::readBoolean() {
@@ -13,15 +13,16 @@
 // limitations under the License.
 
 #include <value/atom.h>
+#include <value/hasher.h>
 #include <rtti/rtti.h>
 #include <stream/byte_stream.h>
 #include <stream/serializer.h>
 #include <parser/parser.h>
 #include <stream/indenting_stream.h>
 
-Value_Atom::Value_Atom(const std::string& n) : mValue(n) {}
+Value_Atom::Value_Atom(const std::string& n) : mValue(n), mHash(HashMix::tagged(ValueType::ATOM, HashMix::of(n))) {}
 
-std::string Value_Atom::value() const {
+const std::string& Value_Atom::value() const {
     return mValue;
 }
 
@@ -32,10 +33,7 @@ std::string Value_Atom::describe() const {
 }
 
 bool Value_Atom::equals(std::shared_ptr<Value> v) const {
-    auto bln = runtime_ptr_cast<Value_Atom>(v);
-    if (bln == nullptr) return false;
-
-    return bln->value() == value();
+    return v.get() == this;
 }
 
 std::shared_ptr<Value> Value_Atom::fromByteStream(ByteStream* bs) {
@@ -59,9 +57,9 @@ std::shared_ptr<Value> Value_Atom::fromParser(Parser* p) {
 }
 
 size_t Value_Atom::hash() const {
-    return std::hash<std::string>()(value()) | 0xA30550A3;
+    return mHash;
 }
 
 std::shared_ptr<Value> Value_Atom::clone() const {
-    return Value::atom(value());
+    return sharedClone();
 }
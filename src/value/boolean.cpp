@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/boolean.h>
+#include <value/hasher.h>
 #include <rtti/rtti.h>
 #include <stream/byte_stream.h>
 #include <stream/serializer.h>
@@ -57,9 +58,9 @@ std::shared_ptr<Value> Value_Boolean::fromParser(Parser* p) {
 }
 
 size_t Value_Boolean::hash() const {
-    return value() ? 0 : 1;
+    return HashMix::tagged(ValueType::BOOLEAN, value());
 }
 
 std::shared_ptr<Value> Value_Boolean::clone() const {
-    return Value::fromBoolean(value());
+    return sharedClone();
 }
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/character.h>
+#include <value/hasher.h>
 #include <rtti/rtti.h>
 #include <stream/byte_stream.h>
 #include <stream/serializer.h>
@@ -77,9 +78,9 @@ std::shared_ptr<Value> Value_Character::fromParser(Parser* p) {
 }
 
 size_t Value_Character::hash() const {
-    return (size_t)value();
+    return HashMix::tagged(ValueType::CHARACTER, value());
 }
 
 std::shared_ptr<Value> Value_Character::clone() const {
-    return Value::fromCharacter(value());
+    return sharedClone();
 }
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/empty.h>
+#include <value/hasher.h>
 #include <rtti/rtti.h>
 #include <stream/serializer.h>
 #include <parser/parser.h>
@@ -43,9 +44,9 @@ std::shared_ptr<Value> Value_Empty::fromParser(Parser*) {
 }
 
 size_t Value_Empty::hash() const {
-    return 0xE101;
+    return HashMix::tagged(ValueType::EMPTY, 0);
 }
 
 std::shared_ptr<Value> Value_Empty::clone() const {
-    return Value::empty();
+    return sharedClone();
 }
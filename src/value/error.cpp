@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/error.h>
+#include <value/hasher.h>
 #include <rtti/rtti.h>
 #include <rtti/enum.h>
 #include <stream/serializer.h>
@@ -62,9 +63,9 @@ std::shared_ptr<Value> Value_Error::fromParser(Parser* p) {
 }
 
 size_t Value_Error::hash() const {
-    return 0xE690000 | enumToNumber(value());
+    return HashMix::tagged(ValueType::ERROR, enumToNumber(value()));
 }
 
 std::shared_ptr<Value> Value_Error::clone() const {
-    return Value::error(value());
+    return sharedClone();
 }
@@ -0,0 +1,78 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/hash_cons.h>
+#include <value/value.h>
+#include <value/tuple.h>
+#include <value/table.h>
+#include <value/set.h>
+#include <value/operation.h>
+#include <operation/op.h>
+#include <rtti/rtti.h>
+
+HashCons::HashCons() = default;
+
+size_t HashCons::size() const {
+    return mValues.size();
+}
+
+std::shared_ptr<Value> HashCons::intern(std::shared_ptr<Value> v) {
+    if (v == nullptr) return v;
+    if (auto op = v->asClass<Value_Operation>()) {
+        op->value()->hashCons(*this);
+        return v;
+    }
+
+    v = internChildren(v);
+    return mValues.add(v, v);
+}
+
+std::shared_ptr<Value> HashCons::internChildren(std::shared_ptr<Value> v) {
+    if (auto tpl = v->asClass<Value_Tuple>()) {
+        // packed numbers have no children to share
+        if (tpl->values().packed()) return v;
+
+        ValueVector vv;
+        bool changed = false;
+        for (size_t i = 0; i < tpl->size(); ++i) {
+            auto chld = tpl->at(i);
+            auto ichld = intern(chld);
+            changed |= (chld != ichld);
+            vv.push_back(ichld);
+        }
+        if (changed) return std::make_shared<Value_Tuple>(vv);
+    } else if (auto tbl = v->asClass<Value_Table>()) {
+        ValueTable vt;
+        bool changed = false;
+        for (size_t i = 0; i < tbl->size(); ++i) {
+            auto key = tbl->keyAt(i), val = tbl->valueAt(i);
+            auto ikey = intern(key), ival = intern(val);
+            changed |= (key != ikey || val != ival);
+            vt.add(ikey, ival);
+        }
+        if (changed) return std::make_shared<Value_Table>(vt);
+    } else if (auto set = v->asClass<Value_Set>()) {
+        ValueSet vs;
+        bool changed = false;
+        for (size_t i = 0; i < set->size(); ++i) {
+            auto val = set->valueAt(i);
+            auto ival = intern(val);
+            changed |= (val != ival);
+            vs.add(ival);
+        }
+        if (changed) return std::make_shared<Value_Set>(vs);
+    }
+
+    return v;
+}
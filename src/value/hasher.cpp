@@ -14,6 +14,15 @@
 
 #include <value/hasher.h>
 #include <value/value.h>
+#include <random>
+
+uint64_t HashMix::seed() {
+    static const uint64_t gSeed = [] {
+        std::random_device rd;
+        return ((uint64_t)rd() << 32) ^ rd();
+    }();
+    return gSeed;
+}
 
 size_t ValueHasher::operator()(const std::shared_ptr<Value>& val) const {
     return val->hash();
@@ -29,16 +29,33 @@ IterableValue::IterableValue() {
 
 IterableValue::~IterableValue() = default;
 
+bool IterableValue::forEachChunk(size_t begin, size_t end, const ChunkCallback& f) const {
+    if (end > size()) end = size();
+    if (begin >= end) return true;
+    return doForEachChunk(begin, end, f);
+}
+bool IterableValue::forEachChunk(const ChunkCallback& f) const {
+    return forEachChunk(0, size(), f);
+}
+
+bool IterableValue::doForEachChunk(size_t begin, size_t end, const ChunkCallback& f) const {
+    ChunkBuffer buf(f);
+    for (size_t i = begin; i < end; ++i) {
+        if (!buf.push(at(i))) return false;
+    }
+    return buf.flush();
+}
+
 bool IterableValue::equals(std::shared_ptr<IterableValue> rhs) const {
     auto vt = dynamic_cast<const Value*>(this);
     auto vr = std::dynamic_pointer_cast<Value>(rhs);
     return vt->equals(vr);
 }
 
-ValueIterator IterableValue::begin() {
+ValueIterator IterableValue::begin() const {
     return ValueIterator(this, 0);
 }
-ValueIterator IterableValue::end() {
+ValueIterator IterableValue::end() const {
     return ValueIterator(this, size());
 }
 
@@ -15,20 +15,52 @@
 #include <value/iterator.h>
 #include <value/value.h>
 
-ValueIterator::ValueIterator(IterableValue* v, size_t i) : mValue(v), mIndex(i) {
+ValueIterator::ValueIterator() : mValue(nullptr), mIndex(0) {}
+
+ValueIterator::ValueIterator(const IterableValue* v, size_t i) : mValue(v), mIndex(i) {
     if (mIndex > mValue->size()) mIndex = mValue->size();
 }
 
 ValueIterator& ValueIterator::operator++() {
-    if(mIndex < mValue->size()) ++mIndex;
+    ++mIndex;
     return *this;
 }
+ValueIterator ValueIterator::operator++(int) {
+    ValueIterator old(*this);
+    ++mIndex;
+    return old;
+}
 ValueIterator& ValueIterator::operator--() {
-    if (mIndex) --mIndex;
+    --mIndex;
     return *this;
 }
 ValueIterator ValueIterator::operator--(int) {
-    return ValueIterator(mValue, mIndex-1);
+    ValueIterator old(*this);
+    --mIndex;
+    return old;
+}
+
+ValueIterator& ValueIterator::operator+=(difference_type n) {
+    mIndex += n;
+    return *this;
+}
+ValueIterator& ValueIterator::operator-=(difference_type n) {
+    mIndex -= n;
+    return *this;
+}
+ValueIterator ValueIterator::operator+(difference_type n) const {
+    ValueIterator it(*this);
+    return it += n;
+}
+ValueIterator ValueIterator::operator-(difference_type n) const {
+    ValueIterator it(*this);
+    return it -= n;
+}
+ValueIterator::difference_type ValueIterator::operator-(const ValueIterator& rhs) const {
+    return (difference_type)mIndex - (difference_type)rhs.mIndex;
+}
+ValueIterator operator+(ValueIterator::difference_type n, const ValueIterator& it) {
+    return it + n;
 }
 
 std::shared_ptr<Value> ValueIterator::operator*() const {
@@ -37,12 +69,29 @@ std::shared_ptr<Value> ValueIterator::operator*() const {
 std::shared_ptr<Value> ValueIterator::operator->() const {
     return mValue->at(mIndex);
 }
+std::shared_ptr<Value> ValueIterator::operator[](difference_type n) const {
+    return mValue->at(mIndex + n);
+}
 
 bool ValueIterator::operator==(const ValueIterator& rhs) const {
-    return mIndex == rhs.mIndex &&
-           dynamic_cast<Value*>(mValue)->equals(dynamic_cast<Value*>(rhs.mValue)->shared_from_this());
+    return mValue == rhs.mValue && mIndex == rhs.mIndex;
 }
 bool ValueIterator::operator!=(const ValueIterator& rhs) const {
-    return mIndex != rhs.mIndex ||
-           !dynamic_cast<Value*>(mValue)->equals(dynamic_cast<Value*>(rhs.mValue)->shared_from_this());
+    return !(*this == rhs);
+}
+bool ValueIterator::operator<(const ValueIterator& rhs) const {
+    return mIndex < rhs.mIndex;
+}
+bool ValueIterator::operator>(const ValueIterator& rhs) const {
+    return rhs < *this;
+}
+bool ValueIterator::operator<=(const ValueIterator& rhs) const {
+    return !(rhs < *this);
+}
+bool ValueIterator::operator>=(const ValueIterator& rhs) const {
+    return !(*this < rhs);
+}
+
+size_t ValueIterator::index() const {
+    return mIndex;
 }
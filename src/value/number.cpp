@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/number.h>
+#include <value/hasher.h>
 #include <stream/indenting_stream.h>
 #include <rtti/rtti.h>
 #include <stream/byte_stream.h>
@@ -65,9 +66,9 @@ std::shared_ptr<Value> Value_Number::fromParser(Parser* p) {
 }
 
 size_t Value_Number::hash() const {
-    return (size_t)value();
+    return HashMix::of(value());
 }
 
 std::shared_ptr<Value> Value_Number::clone() const {
-    return Value::fromNumber(value());
+    return sharedClone();
 }
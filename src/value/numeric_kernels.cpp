@@ -0,0 +1,218 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/numeric_kernels.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NUMERIC_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+#ifdef NUMERIC_KERNELS_X86
+    bool hasAVX2() {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+
+    __attribute__((target("avx2")))
+    uint64_t sumAVX2(const uint64_t* p, size_t n) {
+        __m256i acc = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            acc = _mm256_add_epi64(acc, _mm256_loadu_si256((const __m256i*)(p + i)));
+        }
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256((__m256i*)lanes, acc);
+        uint64_t s = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        for (; i < n; ++i) s += p[i];
+        return s;
+    }
+
+    uint64_t sumSSE2(const uint64_t* p, size_t n) {
+        __m128i acc = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            acc = _mm_add_epi64(acc, _mm_loadu_si128((const __m128i*)(p + i)));
+        }
+        alignas(16) uint64_t lanes[2];
+        _mm_store_si128((__m128i*)lanes, acc);
+        uint64_t s = lanes[0] + lanes[1];
+        for (; i < n; ++i) s += p[i];
+        return s;
+    }
+
+    __attribute__((target("avx2")))
+    bool equalAVX2(const uint64_t* a, const uint64_t* b, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            auto eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                         _mm256_loadu_si256((const __m256i*)(b + i)));
+            if (_mm256_movemask_epi8(eq) != -1) return false;
+        }
+        for (; i < n; ++i) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+
+    bool equalSSE2(const uint64_t* a, const uint64_t* b, size_t n) {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            // two numbers are equal when both of their 32-bit halves are
+            auto eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(a + i)),
+                                      _mm_loadu_si128((const __m128i*)(b + i)));
+            if (_mm_movemask_epi8(eq) != 0xFFFF) return false;
+        }
+        for (; i < n; ++i) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+
+    __attribute__((target("avx2")))
+    bool containsZeroAVX2(const uint64_t* p, size_t n) {
+        const __m256i zero = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            auto eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(p + i)), zero);
+            if (_mm256_movemask_epi8(eq) != 0) return true;
+        }
+        for (; i < n; ++i) {
+            if (p[i] == 0) return true;
+        }
+        return false;
+    }
+
+    bool containsZeroSSE2(const uint64_t* p, size_t n) {
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            auto m = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(p + i)), zero));
+            if ((m & 0x00FF) == 0x00FF || (m & 0xFF00) == 0xFF00) return true;
+        }
+        for (; i < n; ++i) {
+            if (p[i] == 0) return true;
+        }
+        return false;
+    }
+
+    template<bool SUBTRACT>
+    __attribute__((target("avx2")))
+    void addAVX2(uint64_t lhs, const uint64_t* in, uint64_t* out, size_t n) {
+        const __m256i l = _mm256_set1_epi64x((long long)lhs);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            auto r = _mm256_loadu_si256((const __m256i*)(in + i));
+            auto v = SUBTRACT ? _mm256_sub_epi64(l, r) : _mm256_add_epi64(l, r);
+            _mm256_storeu_si256((__m256i*)(out + i), v);
+        }
+        for (; i < n; ++i) out[i] = SUBTRACT ? lhs - in[i] : lhs + in[i];
+    }
+
+    template<bool SUBTRACT>
+    void addSSE2(uint64_t lhs, const uint64_t* in, uint64_t* out, size_t n) {
+        const __m128i l = _mm_set1_epi64x((long long)lhs);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            auto r = _mm_loadu_si128((const __m128i*)(in + i));
+            auto v = SUBTRACT ? _mm_sub_epi64(l, r) : _mm_add_epi64(l, r);
+            _mm_storeu_si128((__m128i*)(out + i), v);
+        }
+        for (; i < n; ++i) out[i] = SUBTRACT ? lhs - in[i] : lhs + in[i];
+    }
+#endif
+
+    template<bool SUBTRACT>
+    void add(uint64_t lhs, const uint64_t* in, uint64_t* out, size_t n) {
+#ifdef NUMERIC_KERNELS_X86
+        if (hasAVX2()) return addAVX2<SUBTRACT>(lhs, in, out, n);
+        return addSSE2<SUBTRACT>(lhs, in, out, n);
+#else
+        for (size_t i = 0; i < n; ++i) out[i] = SUBTRACT ? lhs - in[i] : lhs + in[i];
+#endif
+    }
+}
+
+uint64_t NumericKernels::sum(const uint64_t* p, size_t n) {
+#ifdef NUMERIC_KERNELS_X86
+    if (hasAVX2()) return sumAVX2(p, n);
+    return sumSSE2(p, n);
+#else
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; ++i) s += p[i];
+    return s;
+#endif
+}
+
+uint64_t NumericKernels::product(const uint64_t* p, size_t n) {
+    // there is no packed 64-bit multiply below AVX-512; independent accumulators
+    // at least let the scalar multiplies overlap
+    uint64_t acc[4] = {1, 1, 1, 1};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc[0] *= p[i];
+        acc[1] *= p[i + 1];
+        acc[2] *= p[i + 2];
+        acc[3] *= p[i + 3];
+    }
+    for (; i < n; ++i) acc[0] *= p[i];
+    return acc[0] * acc[1] * acc[2] * acc[3];
+}
+
+bool NumericKernels::equal(const uint64_t* a, const uint64_t* b, size_t n) {
+#ifdef NUMERIC_KERNELS_X86
+    if (hasAVX2()) return equalAVX2(a, b, n);
+    return equalSSE2(a, b, n);
+#else
+    for (size_t i = 0; i < n; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+#endif
+}
+
+bool NumericKernels::containsZero(const uint64_t* p, size_t n) {
+#ifdef NUMERIC_KERNELS_X86
+    if (hasAVX2()) return containsZeroAVX2(p, n);
+    return containsZeroSSE2(p, n);
+#else
+    for (size_t i = 0; i < n; ++i) {
+        if (p[i] == 0) return true;
+    }
+    return false;
+#endif
+}
+
+bool NumericKernels::map(OperationType op, uint64_t lhs, const uint64_t* in, uint64_t* out, size_t n) {
+    switch (op) {
+        case OperationType::ADD:
+            add<false>(lhs, in, out, n);
+            return true;
+        case OperationType::SUBTRACT:
+            add<true>(lhs, in, out, n);
+            return true;
+        case OperationType::MULTIPLY:
+            for (size_t i = 0; i < n; ++i) out[i] = lhs * in[i];
+            return true;
+        case OperationType::DIVIDE:
+            for (size_t i = 0; i < n; ++i) out[i] = lhs / in[i];
+            return true;
+        case OperationType::MODULO:
+            for (size_t i = 0; i < n; ++i) out[i] = lhs % in[i];
+            return true;
+        default:
+            return false;
+    }
+}
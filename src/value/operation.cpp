@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/operation.h>
+#include <value/hasher.h>
 #include <operation/op.h>
 #include <rtti/rtti.h>
 #include <stream/byte_stream.h>
@@ -42,6 +43,8 @@ std::string Value_Operation::describe() const {
 bool Value_Operation::equals(std::shared_ptr<Value> v) const {
     auto blk = runtime_ptr_cast<Value_Operation>(v);
     if (blk == nullptr) return false;
+    if (blk == this || blk->value() == value()) return true;
+    if (mHash.differs(blk->mHash)) return false;
 
     return value()->equals(blk->value());
 }
@@ -67,7 +70,9 @@ std::shared_ptr<Value> Value_Operation::fromParser(Parser* p) {
 }
 
 size_t Value_Operation::hash() const {
-    return 0x0E0000 | enumToNumber(value()->getClassId());
+    return mHash.get([this] {
+        return HashMix::tagged(ValueType::OPERATION, value()->hash());
+    });
 }
 
 Operation::Result Value_Operation::execute(MachineState& ms) {
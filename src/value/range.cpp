@@ -0,0 +1,137 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/range.h>
+#include <value/hasher.h>
+#include <value/number.h>
+#include <value/tuple.h>
+#include <value/typecast_helper.h>
+#include <rtti/rtti.h>
+#include <stream/byte_stream.h>
+#include <stream/serializer.h>
+#include <stream/indenting_stream.h>
+#include <parser/parser.h>
+
+Value_Range::Value_Range(uint64_t first, uint64_t last, uint64_t step) : mFirst(first), mLast(last), mStep(step) {
+    if (mStep == 0 || mLast <= mFirst) mSize = 0;
+    else mSize = (mLast - mFirst - 1) / mStep + 1;
+}
+
+uint64_t Value_Range::first() const {
+    return mFirst;
+}
+
+uint64_t Value_Range::last() const {
+    return mLast;
+}
+
+uint64_t Value_Range::step() const {
+    return mStep;
+}
+
+size_t Value_Range::size() const {
+    return mSize;
+}
+
+std::shared_ptr<Value> Value_Range::at(size_t i) const {
+    if (i >= mSize) return nullptr;
+    return Value::fromNumber(mFirst + i * mStep);
+}
+
+bool Value_Range::doForEachChunk(size_t begin, size_t end, const ChunkCallback& f) const {
+    ChunkBuffer buf(f);
+    for (uint64_t n = mFirst + begin * mStep; begin < end; ++begin, n += mStep) {
+        if (!buf.push(Value::fromNumber(n))) return false;
+    }
+    return buf.flush();
+}
+
+std::string Value_Range::describe() const {
+    IndentingStream is;
+    is.append("range(%llu, %llu, %llu)", mFirst, mLast, mStep);
+    return is.str();
+}
+
+bool Value_Range::equals(std::shared_ptr<Value> v) const {
+    auto rng = runtime_ptr_cast<Value_Range>(v);
+    if (rng == nullptr) return false;
+
+    // ranges are equal if they produce the same numbers
+    if (rng->size() != size()) return false;
+    if (size() == 0) return true;
+    if (rng->first() != first()) return false;
+    return size() == 1 || rng->step() == step();
+}
+
+std::shared_ptr<Value> Value_Range::fromByteStream(ByteStream* bs) {
+    auto first = bs->readNumber();
+    auto last = bs->readNumber();
+    auto step = bs->readNumber();
+    if (!first || !last || !step) return nullptr;
+
+    return Value::range(*first, *last, *step);
+}
+
+size_t Value_Range::serialize(Serializer* s) {
+    size_t wr = s->writeNumber(MARKER, 1);
+    wr += s->writeNumber(mFirst);
+    wr += s->writeNumber(mLast);
+    wr += s->writeNumber(mStep);
+    return wr;
+}
+
+// range first last [step]
+std::shared_ptr<Value> Value_Range::fromParser(Parser* p) {
+    uint64_t bounds[3] = {0, 0, 1};
+    for (size_t i = 0; i < 3; ++i) {
+        std::optional<Token> tok = (i < 2) ? p->expectedError(TokenKind::NUMBER) : p->nextIf(TokenKind::NUMBER);
+        if (!tok) {
+            if (i < 2) return nullptr;
+            break;
+        }
+        const std::string str = tok->value();
+        char* ep = nullptr;
+        bounds[i] = strtoull(str.c_str(), &ep, 0);
+        if (ep && *ep != 0) {
+            p->error("not a valid number");
+            return nullptr;
+        }
+    }
+    if (bounds[2] == 0) {
+        p->error("range step cannot be zero");
+        return nullptr;
+    }
+    return Value::range(bounds[0], bounds[1], bounds[2]);
+}
+
+size_t Value_Range::hash() const {
+    uint64_t h = HashMix::tagged(ValueType::RANGE, size());
+    if (size() > 0) h = HashMix::combine(h, first());
+    if (size() > 1) h = HashMix::combine(h, step());
+    return h;
+}
+
+std::shared_ptr<Value> Value_Range::clone() const {
+    return sharedClone();
+}
+
+std::shared_ptr<Value> Value_Range::doTypecast(ValueType vt) {
+    return TypecastHelper<Value_Range>().onType(ValueType::TUPLE, [] (Value_Range* self) -> std::shared_ptr<Value> {
+        ValueVector vv;
+        for (size_t i = 0; i < self->size(); ++i) {
+            vv.push_back(self->at(i));
+        }
+        return std::make_shared<Value_Tuple>(vv);
+    }).doTypecast(this, vt);
+}
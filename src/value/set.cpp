@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/set.h>
+#include <value/hasher.h>
 #include <value/empty.h>
 #include <stream/indenting_stream.h>
 #include <rtti/rtti.h>
@@ -25,6 +26,8 @@
 
 Value_Set::Value_Set() = default;
 
+Value_Set::Value_Set(const ValueSet& storage) : mSet(storage) {}
+
 Value_Set::Value_Set(std::initializer_list<std::shared_ptr<Value>> elems) {
     for (const auto& elem : elems) {
         append(elem);
@@ -33,6 +36,7 @@ Value_Set::Value_Set(std::initializer_list<std::shared_ptr<Value>> elems) {
 
 SafeAppendableValue<Value_Set*, std::shared_ptr<Value>>::BaseRetType Value_Set::tryAppend(std::shared_ptr<Value> val) {
     mSet.add(val);
+    mHash.reset();
     return this;
 }
 
@@ -49,6 +53,13 @@ std::shared_ptr<Value> Value_Set::valueAt(size_t i) const {
     return v ? v : Value::empty();
 }
 
+bool Value_Set::doForEachChunk(size_t begin, size_t end, const ChunkCallback& f) const {
+    ChunkBuffer buf(f);
+    return mSet.forEach(begin, end, [&buf] (const std::shared_ptr<Value>& v) -> bool {
+        return buf.push(v);
+    }) && buf.flush();
+}
+
 bool Value_Set::find(std::shared_ptr<Value> k) const {
     return mSet.find(k);
 }
@@ -65,8 +76,7 @@ std::string Value_Set::describe() const {
     IndentingStream is;
     is.append("[");
     bool first = true;
-    for(size_t i = 0; i < size(); ++i) {
-        auto v = valueAt(i);
+    mSet.forEach(0, size(), [&] (const std::shared_ptr<Value>& v) -> bool {
         auto vd = v->describe();
         if (first) {
             is.append("%s", vd.c_str());
@@ -74,7 +84,8 @@ std::string Value_Set::describe() const {
         } else {
             is.append(", %s", vd.c_str());
         }
-    }
+        return true;
+    });
     is.append("]");
     return is.str();
 }
@@ -82,15 +93,13 @@ std::string Value_Set::describe() const {
 bool Value_Set::equals(std::shared_ptr<Value> v) const {
     auto tbl = runtime_ptr_cast<Value_Set>(v);
     if (tbl == nullptr) return false;
+    if (tbl == this) return true;
     if (tbl->size() != size()) return false;
+    if (mHash.differs(tbl->mHash)) return false;
 
-    for(size_t i = 0; i < size(); ++i) {
-        auto mk = valueAt(i);
-        auto fd = tbl->find(mk);
-        if (!fd) return false;
-    }
-
-    return true;
+    return mSet.forEach(0, size(), [tbl] (const std::shared_ptr<Value>& mk) -> bool {
+        return tbl->find(mk);
+    });
 }
 
 std::shared_ptr<Value> Value_Set::fromByteStream(ByteStream* bs) {
@@ -112,9 +121,10 @@ std::shared_ptr<Value> Value_Set::fromByteStream(ByteStream* bs) {
 size_t Value_Set::serialize(Serializer* s) {
     size_t wr = s->writeNumber(MARKER, 1);
     wr += s->writeNumber(size());
-    for(size_t i = 0; i < size(); ++i) {
-        wr += valueAt(i)->serialize(s);
-    }
+    mSet.forEach(0, size(), [&wr, s] (const std::shared_ptr<Value>& v) -> bool {
+        wr += v->serialize(s);
+        return true;
+    });
     return wr;
 }
 
@@ -140,28 +150,29 @@ std::shared_ptr<Value> Value_Set::fromParser(Parser* p) {
 }
 
 size_t Value_Set::hash() const {
-    size_t hash = 0xE5EE0000;
-    for (size_t i = 0; i < size(); ++i) {
-        hash += (2 + 3 * (valueAt(i)->hash() + 1));
-    }
-    return hash;
+    return mHash.get([this] {
+        // sets are unordered, so elements are summed rather than combined
+        uint64_t sum = 0;
+        mSet.forEach(0, size(), [&sum] (const std::shared_ptr<Value>& v) -> bool {
+            sum += v->hash();
+            return true;
+        });
+        return HashMix::tagged(ValueType::SET, sum);
+    });
 }
 
 std::shared_ptr<Value> Value_Set::clone() const {
-    auto newTable = std::make_shared<Value_Set>();
-    for(size_t i = 0; i < size(); ++i) {
-        newTable->append(valueAt(i)->clone());
-    }
-    return newTable;
+    return std::make_shared<Value_Set>(mSet);
 }
 
 std::shared_ptr<Value> Value_Set::doTypecast(ValueType vt) {
     return TypecastHelper<Value_Set>().onType(ValueType::TUPLE, [] (Value_Set* self) -> std::shared_ptr<Value> {
         auto val_tpl = Value::tuple({});
 
-        for (size_t i = 0; i < self->size(); ++i) {
-            val_tpl->append(self->valueAt(i));
-        }
+        self->mSet.forEach(0, self->size(), [&val_tpl] (const std::shared_ptr<Value>& v) -> bool {
+            val_tpl->append(v);
+            return true;
+        });
 
         return val_tpl;
     }).doTypecast(this, vt);
@@ -0,0 +1,68 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/shape.h>
+#include <value/value.h>
+
+namespace {
+    std::atomic<uint32_t> gNextId{0};
+}
+
+Shape::Shape() : mId(++gNextId) {}
+
+Shape::Shape(const Shape* parent, const std::shared_ptr<Value>& key) : mId(++gNextId), mKeys(parent->mKeys) {
+    mKeys.push_back(key);
+}
+
+const Shape* Shape::empty() {
+    static Shape gEmpty;
+    return &gEmpty;
+}
+
+uint32_t Shape::id() const {
+    return mId;
+}
+
+size_t Shape::size() const {
+    return mKeys.size();
+}
+
+const std::shared_ptr<Value>& Shape::keyAt(size_t i) const {
+    return mKeys[i];
+}
+
+std::optional<size_t> Shape::slotOf(const Value* key) const {
+    // atoms are interned, so they can be compared by address
+    for (size_t i = 0; i < mKeys.size(); ++i) {
+        if (mKeys[i].get() == key) return i;
+    }
+    return std::nullopt;
+}
+
+const Shape* Shape::with(const std::shared_ptr<Value>& key) const {
+    std::lock_guard<std::mutex> lock(mLock);
+    auto& next = mTransitions[key.get()];
+    if (next == nullptr) next.reset(new Shape(this, key));
+    return next.get();
+}
+
+std::optional<size_t> ShapeCache::slotOf(const Shape* shape, const Value* key) {
+    const uint64_t entry = mEntry.load(std::memory_order_relaxed);
+    const size_t slot = entry & 0xFFFFFFFF;
+    if ((entry >> 32) == shape->id() && slot < shape->size() && shape->keyAt(slot).get() == key) return slot;
+
+    auto found = shape->slotOf(key);
+    if (found) mEntry.store((uint64_t(shape->id()) << 32) | *found, std::memory_order_relaxed);
+    return found;
+}
@@ -13,27 +13,45 @@
 // limitations under the License.
 
 #include <value/string.h>
+#include <value/hasher.h>
 #include <rtti/rtti.h>
 #include <stream/serializer.h>
 #include <stream/byte_stream.h>
 #include <parser/parser.h>
 #include <string>
 #include <functional>
-#include <locale>
-#include <codecvt>
+#include <string.h>
+#include <value/utf8.h>
 #include <value/empty.h>
 #include <value/character.h>
 #include <rtti/visitor.h>
 
-Value_String::Value_String(const std::u32string& s) : mValue(s) {}
+Value_String::Value_String(const std::u32string& s) : mValue(s), mByteSize(0), mLength(0) {}
 
-std::u32string Value_String::value() const {
+Value_String::Value_String(const StringStorage& s) : mValue(s), mByteSize(0), mLength(0) {}
+
+Value_String::Value_String(std::shared_ptr<const char> b, size_t n) : mBytes(b), mByteSize(n), mLength(Utf8::length(b.get(), n)) {}
+
+const StringStorage& Value_String::decoded() const {
+    if (mBytes) {
+        std::call_once(mDecoded, [this] {
+            mValue = Utf8::decodeLossy(mBytes.get(), mByteSize);
+        });
+    }
     return mValue;
 }
 
+std::u32string Value_String::value() const {
+    return decoded().u32();
+}
+
+const StringStorage& Value_String::storage() const {
+    return decoded();
+}
+
 std::string Value_String::utf8() const {
-    std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> convert;
-    return convert.to_bytes(value());
+    if (mBytes) return std::string(mBytes.get(), mByteSize);
+    return Utf8::encode(mValue);
 }
 
 std::string Value_String::describe() const {
@@ -43,8 +61,14 @@ std::string Value_String::describe() const {
 bool Value_String::equals(std::shared_ptr<Value> v) const {
     auto str = runtime_ptr_cast<Value_String>(v);
     if (str == nullptr) return false;
+    if (str == this) return true;
+    if (mHash.differs(str->mHash)) return false;
 
-    return str->value() == value();
+    // valid UTF-8 is canonical, so equal strings have equal bytes
+    if (mBytes && str->mBytes) {
+        return mByteSize == str->mByteSize && memcmp(mBytes.get(), str->mBytes.get(), mByteSize) == 0;
+    }
+    return str->storage() == storage();
 }
 
 size_t Value_String::serialize(Serializer* s) {
@@ -57,8 +81,10 @@ size_t Value_String::serialize(Serializer* s) {
 }
 
 std::shared_ptr<Value> Value_String::fromByteStream(ByteStream* bs) {
-    if (auto sv = bs->readData()) {
-        return Value::fromString(sv.value());
+    if (auto sl = bs->readSlice()) {
+        if (Utf8::validate(sl->data.get(), sl->size)) {
+            return std::make_shared<Value_String>(sl->data, sl->size);
+        }
     }
     
     return nullptr;
@@ -72,35 +98,59 @@ std::shared_ptr<Value> Value_String::fromParser(Parser* p) {
 }
 
 size_t Value_String::hash() const {
-    return std::hash<std::u32string>()(value());
+    return mHash.get([this] {
+        return HashMix::tagged(ValueType::STRING, mBytes ? Utf8::hash(mBytes.get(), mByteSize) : mValue.hash());
+    });
 }
 
 std::shared_ptr<Value> Value_String::clone() const {
-    return Value::fromString(value());
+    if (mBytes) return std::make_shared<Value_String>(mBytes, mByteSize);
+    return std::make_shared<Value_String>(mValue);
 }
 
 size_t Value_String::size() const {
-    return value().size();
+    if (mBytes) return mLength;
+    return mValue.size();
 }
 
 std::shared_ptr<Value> Value_String::at(size_t i) const {
-    if (i >= size()) return Value::empty();
-    return Value::fromCharacter(value().at(i));
+    const auto& val(decoded());
+    if (i >= val.size()) return Value::empty();
+    return Value::fromCharacter(val.at(i));
+}
+
+bool Value_String::doForEachChunk(size_t begin, size_t end, const ChunkCallback& f) const {
+    const auto& val(decoded());
+    ChunkBuffer buf(f);
+    for (size_t i = begin; i < end; ++i) {
+        if (!buf.push(Value::fromCharacter(val.at(i)))) return false;
+    }
+    return buf.flush();
 }
 
 Value_String* Value_String::append(char32_t n) {
-    mValue += n;
+    decoded();
+    mBytes.reset();
+    mValue.append(n);
+    mHash.reset();
     return this;
 }
 
 Value_String* Value_String::append(const std::u32string& s) {
-    mValue += s;
+    return append(StringStorage(s));
+}
+
+Value_String* Value_String::append(const StringStorage& s) {
+    decoded();
+    mBytes.reset();
+    mValue.append(s);
+    mHash.reset();
     return this;
 }
 
 AppendableValue<Value_String*, std::shared_ptr<Value>>::RetType Value_String::tryAppend(std::shared_ptr<Value> val) {
     if (auto chr = val->asClass<Value_Character>()) return append(chr->value());
-    else if (auto str = val->asClass<Value_String>()) return append(str->value());
+    else if (auto str = val->asClass<Value_String>()) return append(str->storage());
     else return ErrorCode::TYPE_MISMATCH;
 }
 
@@ -0,0 +1,123 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/string_storage.h>
+
+namespace {
+    StringStorage::Width widthOf(char32_t c) {
+        if (c <= 0xFF) return StringStorage::Width::LATIN1;
+        if (c <= 0xFFFF) return StringStorage::Width::UCS2;
+        return StringStorage::Width::UTF32;
+    }
+
+    template<typename Dest, typename Source>
+    Dest convert(const Source& src) {
+        Dest dst;
+        dst.reserve(src.end() - src.begin());
+        for (auto c : src) dst.push_back((typename Dest::value_type)c);
+        return dst;
+    }
+}
+
+StringStorage::StringStorage() = default;
+
+StringStorage::StringStorage(std::u32string_view s) {
+    auto w = Width::LATIN1;
+    for (auto c : s) {
+        auto cw = widthOf(c);
+        if (cw > w) w = cw;
+    }
+    switch (w) {
+        case Width::LATIN1:
+            mUnits = convert<std::string>(s);
+            break;
+        case Width::UCS2:
+            mUnits = convert<std::u16string>(s);
+            break;
+        case Width::UTF32:
+            mUnits = std::u32string(s);
+            break;
+    }
+}
+
+StringStorage StringStorage::latin1(std::string s) {
+    StringStorage ss;
+    ss.mUnits = std::move(s);
+    return ss;
+}
+
+StringStorage::Width StringStorage::width() const {
+    switch (mUnits.index()) {
+        case 0: return Width::LATIN1;
+        case 1: return Width::UCS2;
+        default: return Width::UTF32;
+    }
+}
+
+size_t StringStorage::size() const {
+    return std::visit([] (const auto& s) { return s.size(); }, mUnits);
+}
+
+char32_t StringStorage::at(size_t i) const {
+    return visit([i] (auto s) -> char32_t { return s[i]; });
+}
+
+void StringStorage::widen(Width w) {
+    if (w <= width()) return;
+    if (w == Width::UCS2) {
+        mUnits = visit([] (auto s) { return convert<std::u16string>(s); });
+    } else {
+        mUnits = u32();
+    }
+}
+
+void StringStorage::append(char32_t c) {
+    widen(widthOf(c));
+    std::visit([c] (auto& s) { s.push_back((typename std::decay_t<decltype(s)>::value_type)c); }, mUnits);
+}
+
+void StringStorage::append(const StringStorage& other) {
+    if (&other == this) {
+        StringStorage copy(other);
+        return append(copy);
+    }
+    widen(other.width());
+    std::visit([&other] (auto& s) {
+        other.visit([&s] (auto o) {
+            for (auto c : o) s.push_back((typename std::decay_t<decltype(s)>::value_type)c);
+        });
+    }, mUnits);
+}
+
+bool StringStorage::operator==(const StringStorage& other) const {
+    return mUnits == other.mUnits;
+}
+
+bool StringStorage::operator!=(const StringStorage& other) const {
+    return !(*this == other);
+}
+
+size_t StringStorage::hash() const {
+    return visit([] (auto s) -> size_t {
+        uint64_t h = HASH_BASIS;
+        for (auto c : s) h = hashStep(h, c);
+        return h;
+    });
+}
+
+std::u32string StringStorage::u32() const {
+    return visit([] (auto s) -> std::u32string {
+        return convert<std::u32string>(s);
+    });
+}
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/table.h>
+#include <value/hasher.h>
 #include <value/empty.h>
 #include <stream/indenting_stream.h>
 #include <rtti/rtti.h>
@@ -24,6 +25,8 @@
 
 Value_Table::Value_Table() = default;
 
+Value_Table::Value_Table(const ValueTable& storage) : mTable(storage) {}
+
 Value_Table::Value_Table(std::initializer_list<std::pair<std::shared_ptr<Value>,std::shared_ptr<Value>>> elems) {
     for (const auto& elem : elems) {
         append(elem.first, elem.second);
@@ -32,6 +35,7 @@ Value_Table::Value_Table(std::initializer_list<std::pair<std::shared_ptr<Value>,
 
 SafeAppendableValue<Value_Table*, std::shared_ptr<Value>, std::shared_ptr<Value>>::BaseRetType Value_Table::tryAppend(std::shared_ptr<Value> k, std::shared_ptr<Value> v) {
     mTable.add(k, v);
+    mHash.reset();
     return this;
 }
 
@@ -60,6 +64,13 @@ std::shared_ptr<Value> Value_Table::valueAt(size_t i) const {
     auto v = mTable.valueAt(i);
     return v ? v : Value::empty();
 }
+bool Value_Table::doForEachChunk(size_t begin, size_t end, const ChunkCallback& f) const {
+    ChunkBuffer buf(f);
+    return mTable.forEach(begin, end, [&buf] (const std::shared_ptr<Value>& k, const std::shared_ptr<Value>& v) -> bool {
+        return buf.push(Value::tuple({k, v}));
+    }) && buf.flush();
+}
+
 std::shared_ptr<Value> Value_Table::find(std::shared_ptr<Value> k, std::shared_ptr<Value> deft) const {
     auto v = retrieve(k);
     return v ? v : deft;
@@ -71,14 +82,15 @@ bool Value_Table::contains(std::shared_ptr<Value> key) const {
 std::shared_ptr<Value> Value_Table::retrieve(std::shared_ptr<Value> key) const {
     return mTable.find(key);
 }
+std::shared_ptr<Value> Value_Table::retrieve(std::shared_ptr<Value> key, ShapeCache& cache) const {
+    return mTable.find(key, cache);
+}
 
 std::string Value_Table::describe() const {
     IndentingStream is;
     is.append("[");
     bool first = true;
-    for(size_t i = 0; i < size(); ++i) {
-        auto k = keyAt(i);
-        auto v = valueAt(i);
+    mTable.forEach(0, size(), [&] (const std::shared_ptr<Value>& k, const std::shared_ptr<Value>& v) -> bool {
         auto kd = k->describe();
         auto vd = v->describe();
         if (first) {
@@ -87,7 +99,8 @@ std::string Value_Table::describe() const {
         } else {
             is.append(", %s -> %s", kd.c_str(), vd.c_str());
         }
-    }
+        return true;
+    });
     is.append("]");
     return is.str();
 }
@@ -95,16 +108,14 @@ std::string Value_Table::describe() const {
 bool Value_Table::equals(std::shared_ptr<Value> v) const {
     auto tbl = runtime_ptr_cast<Value_Table>(v);
     if (tbl == nullptr) return false;
+    if (tbl == this) return true;
     if (tbl->size() != size()) return false;
+    if (mHash.differs(tbl->mHash)) return false;
 
-    for(size_t i = 0; i < size(); ++i) {
-        auto mk = keyAt(i);
-        auto mv = valueAt(i);
+    return mTable.forEach(0, size(), [tbl] (const std::shared_ptr<Value>& mk, const std::shared_ptr<Value>& mv) -> bool {
         auto tv = tbl->find(mk, Value::empty());
-        if (!mv->equals(tv)) return false;
-    }
-
-    return true;
+        return mv->equals(tv);
+    });
 }
 
 std::shared_ptr<Value> Value_Table::fromByteStream(ByteStream* bs) {
@@ -129,10 +140,11 @@ std::shared_ptr<Value> Value_Table::fromByteStream(ByteStream* bs) {
 size_t Value_Table::serialize(Serializer* s) {
     size_t wr = s->writeNumber(MARKER, 1);
     wr += s->writeNumber(size());
-    for(size_t i = 0; i < size(); ++i) {
-        wr += keyAt(i)->serialize(s);
-        wr += valueAt(i)->serialize(s);
-    }
+    mTable.forEach(0, size(), [&wr, s] (const std::shared_ptr<Value>& k, const std::shared_ptr<Value>& v) -> bool {
+        wr += k->serialize(s);
+        wr += v->serialize(s);
+        return true;
+    });
     return wr;
 }
 
@@ -165,19 +177,19 @@ std::shared_ptr<Value> Value_Table::fromParser(Parser* p) {
 }
 
 size_t Value_Table::hash() const {
-    size_t hash = 0xEBE00000;
-    for (size_t i = 0; i < size(); ++i) {
-        hash += (2 * keyAt(i)->hash() + 3 * (valueAt(i)->hash() + 1));
-    }
-    return hash;
+    return mHash.get([this] {
+        // tables are unordered, so entries are summed rather than combined
+        uint64_t sum = 0;
+        mTable.forEach(0, size(), [&sum] (const std::shared_ptr<Value>& k, const std::shared_ptr<Value>& v) -> bool {
+            sum += HashMix::combine(k->hash(), v->hash());
+            return true;
+        });
+        return HashMix::tagged(ValueType::TABLE, sum);
+    });
 }
 
 std::shared_ptr<Value> Value_Table::clone() const {
-    auto newTable = std::make_shared<Value_Table>();
-    for(size_t i = 0; i < size(); ++i) {
-        newTable->append(keyAt(i)->clone(), valueAt(i)->clone());
-    }
-    return newTable;
+    return std::make_shared<Value_Table>(mTable);
 }
 
 std::shared_ptr<Value> Value_Table::doTypecast(ValueType vt) {
@@ -185,14 +197,10 @@ std::shared_ptr<Value> Value_Table::doTypecast(ValueType vt) {
         auto val_tpl = Value::tuple({});
         auto tpl = val_tpl->asClass<Value_Tuple>();
 
-        for (size_t i = 0; i < self->size(); ++i) {
-            auto key = self->keyAt(i);
-            auto val = self->valueAt(i);
-            auto cvtpl = Value::tuple({});
-            auto ctpl = cvtpl->asClass<Value_Tuple>();
-            ctpl->append(key)->append(val);
-            tpl->append(cvtpl);
-        }
+        self->mTable.forEach(0, self->size(), [tpl] (const std::shared_ptr<Value>& key, const std::shared_ptr<Value>& val) -> bool {
+            tpl->append(Value::tuple({key, val}));
+            return true;
+        });
 
         return val_tpl;
     }).doTypecast(this, vt);
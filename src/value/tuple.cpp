@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/tuple.h>
+#include <value/hasher.h>
 #include <value/empty.h>
 #include <stream/indenting_stream.h>
 #include <rtti/rtti.h>
@@ -29,6 +30,8 @@
 
 Value_Tuple::Value_Tuple() = default;
 
+Value_Tuple::Value_Tuple(const ValueVector& values) : mValues(values) {}
+
 Value_Tuple::Value_Tuple(std::initializer_list<std::shared_ptr<Value>> elems) {
     for (const auto& elem : elems) {
         append(elem);
@@ -37,6 +40,7 @@ Value_Tuple::Value_Tuple(std::initializer_list<std::shared_ptr<Value>> elems) {
 
 SafeAppendableValue<Value_Tuple*, std::shared_ptr<Value>>::BaseRetType Value_Tuple::tryAppend(std::shared_ptr<Value> val) {
     mValues.push_back(val);
+    mHash.reset();
     return this;
 }
 
@@ -52,12 +56,19 @@ std::shared_ptr<Value> Value_Tuple::at(size_t i) const {
     return mValues.at(i);
 }
 
+bool Value_Tuple::doForEachChunk(size_t begin, size_t end, const ChunkCallback& f) const {
+    return mValues.forEachChunk(begin, end, f);
+}
+
+const ValueVector& Value_Tuple::values() const {
+    return mValues;
+}
+
 std::string Value_Tuple::describe() const {
     IndentingStream is;
     is.append("(");
     bool first = true;
-    for(size_t i = 0; i < size(); ++i) {
-        auto vl = at(i);
+    forEach([&] (const std::shared_ptr<Value>& vl) -> bool {
         auto dsc = vl->describe();
         if (first) {
             is.append("%s", dsc.c_str());
@@ -65,7 +76,8 @@ std::string Value_Tuple::describe() const {
         } else {
             is.append(", %s", dsc.c_str());
         }
-    }
+        return true;
+    });
     is.append(")");
     return is.str();
 }
@@ -73,13 +85,23 @@ std::string Value_Tuple::describe() const {
 bool Value_Tuple::equals(std::shared_ptr<Value> v) const {
     auto tpl = runtime_ptr_cast<Value_Tuple>(v);
     if (tpl == nullptr) return false;
+    if (tpl == this) return true;
     if (tpl->size() != size()) return false;
-
-    for (size_t i = 0; i < size(); ++i) {
-        if (!tpl->at(i)->equals(at(i))) return false;
-    }
-
-    return true;
+    if (mHash.differs(tpl->mHash)) return false;
+    if (auto eq = mValues.equalNumbers(tpl->mValues)) return *eq;
+
+    size_t i = 0;
+    return forEachChunk([&] (const std::shared_ptr<Value>* a, size_t n) -> bool {
+        bool eq = tpl->forEachChunk(i, i + n, [&a] (const std::shared_ptr<Value>* b, size_t m) -> bool {
+            for (size_t j = 0; j < m; ++j) {
+                if (!b[j]->equals(a[j])) return false;
+            }
+            a += m;
+            return true;
+        });
+        i += n;
+        return eq;
+    });
 }
 
 std::shared_ptr<Value> Value_Tuple::fromByteStream(ByteStream* bs) {
@@ -102,9 +124,10 @@ std::shared_ptr<Value> Value_Tuple::fromByteStream(ByteStream* bs) {
 size_t Value_Tuple::serialize(Serializer* s) {
     size_t wr = s->writeNumber(MARKER, 1);
     wr += s->writeNumber(size());
-    for(size_t i = 0; i < size(); ++i) {
-        wr += at(i)->serialize(s);
-    }
+    forEach([&wr, s] (const std::shared_ptr<Value>& v) -> bool {
+        wr += v->serialize(s);
+        return true;
+    });
     return wr;
 }
 
@@ -130,47 +153,44 @@ std::shared_ptr<Value> Value_Tuple::fromParser(Parser* p) {
 }
 
 size_t Value_Tuple::hash() const {
-    size_t hash = 0x38E00000;
-    for (size_t i = 0; i < size(); ++i) {
-        hash += at(i)->hash();
-    }
-    return hash;
+    return mHash.get([this] {
+        uint64_t hash = HashMix::tagged(ValueType::TUPLE, size());
+        if (auto packed = mValues.hashNumbers(hash)) return *packed;
+        forEach([&hash] (const std::shared_ptr<Value>& v) -> bool {
+            hash = HashMix::combine(hash, v->hash());
+            return true;
+        });
+        return hash;
+    });
 }
 
 std::shared_ptr<Value> Value_Tuple::clone() const {
-    auto newTuple = std::make_shared<Value_Tuple>();
-    for(size_t i = 0; i < size(); ++i) {
-        newTuple->append(at(i)->clone());
-    }
-    return newTuple;
+    return std::make_shared<Value_Tuple>(mValues);
 }
 
 std::shared_ptr<Value> Value_Tuple::doTypecast(ValueType vt) {
     return TypecastHelper<Value_Tuple>().onType(ValueType::BLOCK, [] (Value_Tuple* self) -> std::shared_ptr<Value> {
         std::shared_ptr<Block> blk(new Block());
 
-        for (size_t i = 0; i < self->size(); ++i) {
-            auto elem = self->at(i);
-            if (elem->isOfClass<Value_Operation>()) {
-                blk->add(runtime_ptr_cast<Value_Operation>(elem)->value());
-            } else {
-                return nullptr;
-            }
-        }
+        bool ok = self->forEach([&blk] (const std::shared_ptr<Value>& elem) -> bool {
+            auto vop = runtime_ptr_cast<Value_Operation>(elem);
+            if (vop) blk->add(vop->value());
+            return vop != nullptr;
+        });
 
-        return Value::fromBlock(blk);
+        return ok ? Value::fromBlock(blk) : nullptr;
     }).onType(ValueType::TABLE, [] (Value_Tuple* self) -> std::shared_ptr<Value> {
         auto vtbl = Value::table({});
         auto tbl = vtbl->asClass<Value_Table>();
 
-        for (size_t i = 0; i < self->size(); ++i) {
-            auto velem = self->at(i);
+        bool ok = self->forEach([tbl] (const std::shared_ptr<Value>& velem) -> bool {
             auto telem = velem->asClass<Value_Tuple>();
-            if (telem == nullptr || telem->size() != 2) return nullptr;
+            if (telem == nullptr || telem->size() != 2) return false;
             tbl->append(telem->at(0), telem->at(1));
-        }
+            return true;
+        });
 
-        return vtbl;
+        return ok ? vtbl : nullptr;
     }).onType(ValueType::BIND, [] (Value_Tuple* self) -> std::shared_ptr<Value> {
         if (self->size() != 2) return nullptr;
         if (self->at(1)->asClass<Value_Operation>() == nullptr) return nullptr;
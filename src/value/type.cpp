@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <value/type.h>
+#include <value/hasher.h>
 #include <value/value_types.h>
 #include <rtti/rtti.h>
 #include <rtti/enum.h>
@@ -66,9 +67,9 @@ std::shared_ptr<Value> Value_Type::fromParser(Parser* p) {
 }
 
 size_t Value_Type::hash() const {
-    return 0x31E0000 | enumToNumber(value());
+    return HashMix::tagged(ValueType::TYPE, enumToNumber(value()));
 }
 
 std::shared_ptr<Value> Value_Type::clone() const {
-    return Value::type(value());
+    return sharedClone();
 }
@@ -0,0 +1,192 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/utf8.h>
+#include <string.h>
+#include <rtti/visitor.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // decodes the sequence starting at p[i], advancing i past it; returns false if malformed
+    bool decodeSequence(const uint8_t* p, size_t n, size_t& i, char32_t& cp) {
+        const uint8_t b = p[i];
+        size_t len;
+        char32_t min;
+        if ((b & 0xE0) == 0xC0) {
+            len = 2;
+            cp = b & 0x1F;
+            min = 0x80;
+        } else if ((b & 0xF0) == 0xE0) {
+            len = 3;
+            cp = b & 0x0F;
+            min = 0x800;
+        } else if ((b & 0xF8) == 0xF0) {
+            len = 4;
+            cp = b & 0x07;
+            min = 0x10000;
+        } else {
+            return false;
+        }
+
+        if (n - i < len) return false;
+        for (size_t k = 1; k < len; ++k) {
+            const uint8_t c = p[i + k];
+            if ((c & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (c & 0x3F);
+        }
+        if (cp < min || cp > 0x10FFFF) return false;
+        if (cp >= 0xD800 && cp <= 0xDFFF) return false;
+
+        i += len;
+        return true;
+    }
+
+    // calls sink(const uint8_t*, size_t) for each run of ASCII and sink(char32_t) for every other code point
+    template<bool LOSSY, typename Sink>
+    bool scan(const char* s, size_t n, Sink&& sink) {
+        const uint8_t* p = (const uint8_t*)s;
+        size_t i = 0;
+        while (i < n) {
+            if (p[i] < 0x80) {
+                const size_t run = Utf8::asciiPrefix(s + i, n - i);
+                sink(p + i, run);
+                i += run;
+                continue;
+            }
+            char32_t cp;
+            if (decodeSequence(p, n, i, cp)) {
+                sink(cp);
+            } else if (LOSSY) {
+                sink(Utf8::REPLACEMENT);
+                ++i;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<bool LOSSY>
+    bool decodeInto(const char* s, size_t n, std::u32string& out) {
+        out.reserve(n);
+        return scan<LOSSY>(s, n, overloaded {
+            [&out] (const uint8_t* ascii, size_t run) { out.append(ascii, ascii + run); },
+            [&out] (char32_t cp) { out.push_back(cp); },
+        });
+    }
+
+    void encodeCodePoint(char32_t cp, std::string& out) {
+        if (cp >= 0xD800 && cp <= 0xDFFF) cp = Utf8::REPLACEMENT;
+        if (cp > 0x10FFFF) cp = Utf8::REPLACEMENT;
+
+        if (cp < 0x80) {
+            out.push_back((char)cp);
+        } else if (cp < 0x800) {
+            out.push_back((char)(0xC0 | (cp >> 6)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back((char)(0xE0 | (cp >> 12)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back((char)(0xF0 | (cp >> 18)));
+            out.push_back((char)(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((char)(0x80 | (cp & 0x3F)));
+        }
+    }
+}
+
+size_t Utf8::asciiPrefix(const char* s, size_t n) {
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= n; i += 16) {
+        const int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(s + i)));
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+#else
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        memcpy(&word, s + i, sizeof(word));
+        if (word & 0x8080808080808080ull) break;
+    }
+#endif
+    while (i < n && (uint8_t)s[i] < 0x80) ++i;
+    return i;
+}
+
+std::optional<StringStorage> Utf8::decode(const char* s, size_t n) {
+    if (asciiPrefix(s, n) == n) return StringStorage::latin1(std::string(s, n));
+
+    std::u32string out;
+    if (!decodeInto<false>(s, n, out)) return std::nullopt;
+    return StringStorage(out);
+}
+
+StringStorage Utf8::decodeLossy(const char* s, size_t n) {
+    if (asciiPrefix(s, n) == n) return StringStorage::latin1(std::string(s, n));
+
+    std::u32string out;
+    decodeInto<true>(s, n, out);
+    return StringStorage(out);
+}
+
+bool Utf8::validate(const char* s, size_t n) {
+    return scan<false>(s, n, overloaded {
+        [] (const uint8_t*, size_t) {},
+        [] (char32_t) {},
+    });
+}
+
+size_t Utf8::length(const char* s, size_t n) {
+    size_t len = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (((uint8_t)s[i] & 0xC0) != 0x80) ++len;
+    }
+    return len;
+}
+
+size_t Utf8::hash(const char* s, size_t n) {
+    uint64_t h = StringStorage::HASH_BASIS;
+    scan<true>(s, n, overloaded {
+        [&h] (const uint8_t* ascii, size_t run) {
+            for (size_t i = 0; i < run; ++i) h = StringStorage::hashStep(h, ascii[i]);
+        },
+        [&h] (char32_t cp) { h = StringStorage::hashStep(h, cp); },
+    });
+    return h;
+}
+
+std::string Utf8::encode(const StringStorage& ss) {
+    return ss.visit([] (auto units) -> std::string {
+        std::string out;
+        out.reserve(units.size);
+        size_t i = 0;
+        while (i < units.size) {
+            if constexpr (sizeof(units[0]) == 1) {
+                const char* bytes = (const char*)units.data;
+                const size_t run = asciiPrefix(bytes + i, units.size - i);
+                out.append(bytes + i, run);
+                i += run;
+                if (i == units.size) break;
+            }
+            encodeCodePoint(units[i], out);
+            ++i;
+        }
+        return out;
+    });
+}
@@ -25,6 +25,8 @@
 #include <value/table.h>
 #include <value/set.h>
 #include <value/atom.h>
+#include <value/range.h>
+#include <uniq/uniq.h>
 #include <value/bind.h>
 #include <value/character.h>
 #include <operation/op.h>
@@ -35,12 +37,16 @@
 #include <operation/bind.h>
 #include <parser/parser.h>
 #include <value/value_loader.h>
-#include <locale>
-#include <codecvt>
+#include <value/utf8.h>
+#include <array>
 
 Value::Value() = default;
 Value::~Value() = default;
 
+std::shared_ptr<Value> Value::sharedClone() const {
+    return std::const_pointer_cast<Value>(shared_from_this());
+}
+
 bool Value::isOfType(ValueType vt) const {
     return (vt == ValueType::NONE);
 }
@@ -70,12 +76,18 @@ std::shared_ptr<Value_String> Value::fromString(const std::u32string& s) {
 }
 
 std::shared_ptr<Value_Character> Value::fromCharacter(char32_t c) {
+    // characters are immutable, so the ASCII ones are shared rather than allocated each time
+    static const auto gAscii = [] {
+        std::array<std::shared_ptr<Value_Character>, 128> chars;
+        for (size_t i = 0; i < chars.size(); ++i) chars[i] = std::make_shared<Value_Character>((char32_t)i);
+        return chars;
+    }();
+    if (c < gAscii.size()) return gAscii[c];
     return std::make_shared<Value_Character>(c);
 }
 
 std::shared_ptr<Value_String> Value::fromString(const std::string& s) {
-    std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> convert;
-    return std::make_shared<Value_String>(convert.from_bytes(s));
+    return std::make_shared<Value_String>(Utf8::decodeLossy(s.data(), s.size()));
 }
 
 std::shared_ptr<Value_Error> Value::error(ErrorCode ec) {
@@ -91,7 +103,13 @@ std::shared_ptr<Value_Operation> Value::fromBind(std::shared_ptr<PartialBind> pb
 }
 
 std::shared_ptr<Value_Atom> Value::atom(const std::string& a) {
-    return std::make_shared<Value_Atom>(a);
+    static Uniq<Value_Atom, std::string> gAtoms;
+    if (auto atom = gAtoms.find(a)) return atom;
+    return gAtoms.add(a, std::shared_ptr<Value_Atom>(new Value_Atom(a)));
+}
+
+std::shared_ptr<Value_Range> Value::range(uint64_t first, uint64_t last, uint64_t step) {
+    return std::make_shared<Value_Range>(first, last, step);
 }
 
 std::shared_ptr<Value> Value::fromByteStream(ByteStream* bs) {
@@ -27,18 +27,9 @@ ValueLoader* ValueLoader::loader() {
 ValueLoader::ValueLoader() = default;
 ValueLoader::~ValueLoader() = default;
 
-void ValueLoader::addLoader(uint8_t op, LoaderFunction f) {
-    mLoaders.emplace(op, f);
-}
-
-void ValueLoader::addParser(ValueType op, ParserFunction f) {
-    mParsers.emplace(op, f);
-}
-
 std::shared_ptr<Value> ValueLoader::fromByteStream(ByteStream* bs) {
     if (auto mk = bs->readNumber(1)) {
-        auto iter = mLoaders.find(mk.value()), end = mLoaders.end();
-        if (iter != end) return iter->second(bs);
+        if (auto f = loaderFor(mk.value())) return f(bs);
     }
 
     return nullptr;
@@ -49,8 +40,7 @@ std::shared_ptr<Value> ValueLoader::fromParser(Parser* p) {
     auto id = p->expectedError(TokenKind::IDENTIFIER);
     if (id == std::nullopt) return nullptr;
     if (auto ot = valueTypeFromString(id->value())) {
-        auto iter = mParsers.find(ot.value()), end = mParsers.end();
-        if (iter != end) val = iter->second(p);
+        if (auto f = parserFor(ot.value())) val = f(p);
     }
     if (val) return val;
     else return nullptr;
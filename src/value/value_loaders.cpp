@@ -24,19 +24,56 @@
 #include <value/error.h>
 #include <value/number.h>
 #include <value/operation.h>
+#include <value/range.h>
 #include <value/set.h>
 #include <value/string.h>
 #include <value/table.h>
 #include <value/tuple.h>
 #include <value/type.h>
+#include <value/view.h>
 
+#include <rtti/enum.h>
+#include <array>
+
+namespace {
+    template<typename T>
+    std::shared_ptr<Value> loadValue(ByteStream* bs) {
+        return T::fromByteStream(bs);
+    }
+    template<typename T>
+    std::shared_ptr<Value> parseValue(Parser* p) {
+        return T::fromParser(p);
+    }
+
+    using Loaders = std::array<ValueLoader::LoaderFunction, 256>;
+    using Parsers = std::array<ValueLoader::ParserFunction, enumToNumber(std::numeric_limits<ValueType>::max()) + 1>;
+
+    constexpr Loaders makeLoaders() {
+        Loaders t{};
 #define VALUE_TYPE(NAME, TOKEN, STRING, NUMBER, CLASS) \
-void ValueLoader ## CLASS () { \
-            ValueLoader::loader()->addLoader(CLASS :: MARKER, [] (ByteStream* bs) -> std::shared_ptr<Value> { \
-                return CLASS ::fromByteStream(bs); \
-            }); \
-            ValueLoader::loader()->addParser(ValueType:: NAME, [] (Parser* p) -> std::shared_ptr<Value> { \
-                return CLASS ::fromParser(p); \
-            }); \
-}
+        if (t[CLASS :: MARKER] != nullptr) throw "duplicate value marker"; \
+        t[CLASS :: MARKER] = &loadValue<CLASS>;
+#include <value/value_types.def>
+        return t;
+    }
+    constexpr Parsers makeParsers() {
+        Parsers t{};
+#define VALUE_TYPE(NAME, TOKEN, STRING, NUMBER, CLASS) \
+        t[NUMBER] = &parseValue<CLASS>;
 #include <value/value_types.def>
+        return t;
+    }
+
+    constexpr Loaders gLoaders = makeLoaders();
+    constexpr Parsers gParsers = makeParsers();
+}
+
+ValueLoader::LoaderFunction ValueLoader::loaderFor(uint8_t marker) {
+    return gLoaders[marker];
+}
+
+ValueLoader::ParserFunction ValueLoader::parserFor(ValueType vt) {
+    auto n = enumToNumber(vt);
+    if (n >= gParsers.size()) return nullptr;
+    return gParsers[n];
+}
@@ -13,18 +13,17 @@
 // limitations under the License.
 
 #include <value/value_set.h>
-#include <iterator>
 #include <value/tuple.h>
 #include <rtti/rtti.h>
 
 ValueSet::ValueSet() = default;
 
 bool ValueSet::add(std::shared_ptr<Value> v) {
-    return mSet.emplace(v).second;
+    return mSet.insert(Entry{v, 0});
 }
 
 bool ValueSet::find(std::shared_ptr<Value> k) const {
-    return mSet.count(k) == 1;
+    return mSet.find(k) != nullptr;
 }
 
 size_t ValueSet::size() const {
@@ -33,7 +32,5 @@ size_t ValueSet::size() const {
 
 std::shared_ptr<Value> ValueSet::at(size_t n) const {
     if (n >= size()) return nullptr;
-    auto iter = mSet.begin();
-    std::advance(iter, n);
-    return *iter;
+    return mSet.at(n).key;
 }
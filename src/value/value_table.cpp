@@ -13,48 +13,148 @@
 // limitations under the License.
 
 #include <value/value_table.h>
-#include <iterator>
 #include <value/tuple.h>
+#include <value/number.h>
+#include <value/atom.h>
 #include <rtti/rtti.h>
+#include <algorithm>
 
-ValueTable::ValueTable() = default;
+ValueTable::ValueTable() : mStorage(Dense{0, {}, {}}) {}
+
+bool ValueTable::dense() const {
+    return std::holds_alternative<Dense>(mStorage);
+}
+
+const Shape* ValueTable::shape() const {
+    if (auto rc = std::get_if<Record>(&mStorage)) return rc->shape;
+    return nullptr;
+}
+
+std::optional<bool> ValueTable::addDense(Dense& dn, uint64_t key, const Entry& e) {
+    if (dn.entries.empty()) dn.base = key;
+    const uint64_t limit = DENSITY * (dn.entries.size() + 1) + DENSE_SLACK;
+
+    if (key < dn.base) {
+        // move the base down, leaving room below it so that descending keys don't rebuild every time
+        // grow can be close to 2^64, so compare against what is left of limit rather than adding
+        const uint64_t grow = dn.base - key;
+        if (grow > limit || dn.slots.size() > limit - grow) return std::nullopt;
+        const uint64_t room = std::min<uint64_t>({key, dn.slots.size(), limit - dn.slots.size() - grow});
+
+        PersistentVector<uint32_t> slots;
+        for (uint64_t i = 0; i < grow + room; ++i) slots.push_back(0);
+        dn.slots.forEachChunk(0, dn.slots.size(), [&slots] (const uint32_t* p, size_t n) {
+            for (size_t i = 0; i < n; ++i) slots.push_back(p[i]);
+        });
+        dn.slots = std::move(slots);
+        dn.base = key - room;
+    }
+
+    const uint64_t idx = key - dn.base;
+    if (idx < dn.slots.size()) {
+        if (dn.slots[idx] != 0) return false;
+    } else if (idx >= limit) {
+        return std::nullopt;
+    } else {
+        while (dn.slots.size() <= idx) dn.slots.push_back(0);
+    }
+
+    dn.entries.push_back(e);
+    dn.slots.set(idx, (uint32_t)dn.entries.size());
+    return true;
+}
+
+std::optional<bool> ValueTable::addRecord(Record& rc, const std::shared_ptr<Value>& k, const std::shared_ptr<Value>& v) {
+    if (!k->isOfClass<Value_Atom>()) return std::nullopt;
+    if (rc.shape->slotOf(k.get())) return false;
+    if (rc.shape->size() == Shape::MAX_SIZE) return std::nullopt;
+
+    rc.shape = rc.shape->with(k);
+    rc.values.push_back(v);
+    return true;
+}
+
+void ValueTable::makeHashed() {
+    Hashed map;
+    forEach(0, size(), [&map] (const std::shared_ptr<Value>& k, const std::shared_ptr<Value>& v) -> bool {
+        map.insert(Entry{k, v, 0});
+        return true;
+    });
+    mStorage = std::move(map);
+}
 
 bool ValueTable::add(std::shared_ptr<Value> k, std::shared_ptr<Value> v) {
-    return mMap.try_emplace(k, v).second;
+    if (auto dn = std::get_if<Dense>(&mStorage)) {
+        if (auto num = k->asClass<Value_Number>()) {
+            if (auto added = addDense(*dn, num->value(), Entry{k, v, 0})) return added.value();
+        }
+        if (dn->entries.empty() && k->isOfClass<Value_Atom>()) {
+            mStorage = Record{Shape::empty(), {}};
+        } else {
+            makeHashed();
+        }
+    }
+    if (auto rc = std::get_if<Record>(&mStorage)) {
+        if (auto added = addRecord(*rc, k, v)) return added.value();
+        makeHashed();
+    }
+    return std::get<Hashed>(mStorage).insert(Entry{k, v, 0});
 }
 
 std::shared_ptr<Value> ValueTable::find(std::shared_ptr<Value> k) const {
-    auto i = mMap.find(k), e = mMap.end();
-    if (i == e) return nullptr;
-    return i->second;
+    if (auto rc = std::get_if<Record>(&mStorage)) {
+        // every key is an atom, and atoms only equal themselves
+        auto slot = rc->shape->slotOf(k.get());
+        return slot ? rc->values[*slot] : nullptr;
+    }
+    if (auto dn = std::get_if<Dense>(&mStorage)) {
+        // every key is a number, and numbers only equal numbers
+        auto num = k->asClass<Value_Number>();
+        if (num == nullptr || num->value() < dn->base) return nullptr;
+        const uint64_t idx = num->value() - dn->base;
+        if (idx >= dn->slots.size()) return nullptr;
+        const uint32_t pos = dn->slots[idx];
+        if (pos == 0) return nullptr;
+        return dn->entries[pos - 1].value;
+    }
+
+    auto e = std::get<Hashed>(mStorage).find(k);
+    if (e == nullptr) return nullptr;
+    return e->value;
+}
+
+std::shared_ptr<Value> ValueTable::find(std::shared_ptr<Value> k, ShapeCache& cache) const {
+    if (auto rc = std::get_if<Record>(&mStorage)) {
+        auto slot = cache.slotOf(rc->shape, k.get());
+        return slot ? rc->values[*slot] : nullptr;
+    }
+    return find(k);
 }
 
 size_t ValueTable::size() const {
-    return mMap.size();
+    if (auto rc = std::get_if<Record>(&mStorage)) return rc->values.size();
+    if (auto dn = std::get_if<Dense>(&mStorage)) return dn->entries.size();
+    return std::get<Hashed>(mStorage).size();
+}
+
+const ValueTable::Entry& ValueTable::entryAt(size_t n) const {
+    if (auto dn = std::get_if<Dense>(&mStorage)) return dn->entries[n];
+    return std::get<Hashed>(mStorage).at(n);
 }
 
 std::shared_ptr<Value> ValueTable::keyAt(size_t n) const {
     if (n >= size()) return nullptr;
-    auto iter = mMap.begin();
-    std::advance(iter, n);
-    return iter->first;
+    if (auto rc = std::get_if<Record>(&mStorage)) return rc->shape->keyAt(n);
+    return entryAt(n).key;
 }
 
 std::shared_ptr<Value> ValueTable::valueAt(size_t n) const {
     if (n >= size()) return nullptr;
-    auto iter = mMap.begin();
-    std::advance(iter, n);
-    return iter->second;
+    if (auto rc = std::get_if<Record>(&mStorage)) return rc->values[n];
+    return entryAt(n).value;
 }
 
 std::shared_ptr<Value> ValueTable::at(size_t n) const {
     if (n >= size()) return nullptr;
-    auto k = keyAt(n);
-    auto v = valueAt(n);
-    auto vtpl = Value::tuple({});
-    auto tpl = runtime_ptr_cast<Value_Tuple>(vtpl);
-    tpl->append(k);
-    tpl->append(v);
-    return vtpl;
+    return Value::tuple({keyAt(n), valueAt(n)});
 }
-
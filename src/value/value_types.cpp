@@ -14,6 +14,7 @@
 
 #include <value/value_types.h>
 #include <stream/byte_stream.h>
+#include <parser/perfect_hash.h>
 
 #define VALUE_TYPE(NAME, TOKEN, STRING, VALUE, CLASS) \
     case ValueType:: NAME : { static_assert(VALUE <= enumToNumber(std::numeric_limits<ValueType>::max())); return STRING; };
@@ -37,10 +38,20 @@ std::optional<ValueType> valueTypeFromByteStream(ByteStream* bs) {
     return std::nullopt;
 }
 
-#define VALUE_TYPE(NAME, TOKEN, STRING, VALUE, CLASS) \
-    if (s == #TOKEN) return ValueType:: NAME;
+namespace {
+    constexpr size_t NUM_VALUE_TYPES = 0
+#define VALUE_TYPE(NAME, TOKEN, STRING, VALUE, CLASS) + 1
+#include <value/value_types.def>
+    ;
 
-std::optional<ValueType> valueTypeFromString(const std::string& s) {
+    using Keywords = PerfectHash<ValueType, NUM_VALUE_TYPES, 64>;
+
+    constexpr Keywords gKeywords(std::array<Keywords::Entry, NUM_VALUE_TYPES>{{
+#define VALUE_TYPE(NAME, TOKEN, STRING, VALUE, CLASS) Keywords::Entry{#TOKEN, ValueType:: NAME},
 #include <value/value_types.def>
-    return std::nullopt;
+    }});
+}
+
+std::optional<ValueType> valueTypeFromString(const std::string& s) {
+    return gKeywords.find(s);
 }
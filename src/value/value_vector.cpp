@@ -0,0 +1,289 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/value_vector.h>
+#include <value/hasher.h>
+#include <value/value.h>
+#include <value/number.h>
+#include <value/numeric_kernels.h>
+#include <rtti/rtti.h>
+#include <algorithm>
+#include <array>
+
+ValueVector::ValueVector() : mBegin(0), mSize(0) {}
+
+size_t ValueVector::size() const {
+    return mSize;
+}
+
+bool ValueVector::isInline() const {
+    return std::holds_alternative<Inline>(mStorage);
+}
+
+bool ValueVector::persistent() const {
+    return std::holds_alternative<Persistent>(mStorage);
+}
+
+bool ValueVector::packed() const {
+    return std::holds_alternative<Packed>(mStorage);
+}
+
+std::shared_ptr<Value> ValueVector::at(size_t i) const {
+    if (i >= mSize) return nullptr;
+    if (auto inl = std::get_if<Inline>(&mStorage)) return (*inl)[i];
+    if (auto flat = std::get_if<Flat>(&mStorage)) return (*flat)[i];
+    if (auto pk = std::get_if<Packed>(&mStorage)) return Value::fromNumber((*pk)[mBegin + i]);
+    return std::get<Persistent>(mStorage)[mBegin + i];
+}
+
+bool ValueVector::forEachChunk(size_t begin, size_t end, const std::function<bool(const std::shared_ptr<Value>*, size_t)>& f) const {
+    if (end > mSize) end = mSize;
+    if (begin >= end) return true;
+
+    if (auto inl = std::get_if<Inline>(&mStorage)) return f(inl->data() + begin, end - begin);
+    if (auto flat = std::get_if<Flat>(&mStorage)) return f(flat->data() + begin, end - begin);
+
+    bool more = true;
+    if (auto pk = std::get_if<Packed>(&mStorage)) {
+        std::array<std::shared_ptr<Value>, CHUNK_SIZE> buf;
+        pk->forEachChunk(mBegin + begin, mBegin + end, [&] (const uint64_t* p, size_t n) {
+            while (more && n > 0) {
+                const size_t m = std::min(n, CHUNK_SIZE);
+                for (size_t i = 0; i < m; ++i) buf[i] = Value::fromNumber(p[i]);
+                more = f(buf.data(), m);
+                p += m;
+                n -= m;
+            }
+        });
+        return more;
+    }
+
+    std::get<Persistent>(mStorage).forEachChunk(mBegin + begin, mBegin + end, [&] (const std::shared_ptr<Value>* p, size_t n) {
+        if (more) more = f(p, n);
+    });
+    return more;
+}
+
+void ValueVector::spill(const std::shared_ptr<Value>& next) {
+    const auto& inl = std::get<Inline>(mStorage);
+    const bool numbers = next->isOfClass<Value_Number>() && std::all_of(inl.begin(), inl.begin() + mSize, [] (const std::shared_ptr<Value>& v) {
+        return v->isOfClass<Value_Number>();
+    });
+
+    if (numbers) {
+        Packed pk;
+        for (size_t i = 0; i < mSize; ++i) {
+            pk.push_back(inl[i]->asClass<Value_Number>()->value());
+        }
+        mStorage = std::move(pk);
+    } else {
+        Flat flat;
+        flat.reserve(SMALL_SIZE);
+        flat.insert(flat.end(), inl.begin(), inl.begin() + mSize);
+        mStorage = std::move(flat);
+    }
+    mBegin = 0;
+}
+
+void ValueVector::unpack() {
+    if (mSize <= INLINE_SIZE) {
+        Inline inl;
+        for (size_t i = 0; i < mSize; ++i) {
+            inl[i] = at(i);
+        }
+        mStorage = std::move(inl);
+    } else if (mSize <= SMALL_SIZE) {
+        Flat flat;
+        for (size_t i = 0; i < mSize; ++i) {
+            flat.push_back(at(i));
+        }
+        mStorage = std::move(flat);
+    } else {
+        Persistent pv;
+        for (size_t i = 0; i < mSize; ++i) {
+            pv.push_back(at(i));
+        }
+        mStorage = std::move(pv);
+    }
+    mBegin = 0;
+}
+
+void ValueVector::makePersistent() {
+    Persistent pv;
+    for (size_t i = 0; i < mSize; ++i) {
+        pv.push_back(at(i));
+    }
+    mStorage = std::move(pv);
+    mBegin = 0;
+}
+
+void ValueVector::pushNumber(uint64_t num) {
+    auto& pk = std::get<Packed>(mStorage);
+    if (mBegin + mSize != pk.size()) {
+        // a slice that ends before the storage it shares can't grow in place
+        Packed copy;
+        forEachNumberChunk([&copy] (const uint64_t* p, size_t n) {
+            for (size_t i = 0; i < n; ++i) copy.push_back(p[i]);
+        });
+        pk = std::move(copy);
+        mBegin = 0;
+    }
+    pk.push_back(num);
+    ++mSize;
+}
+
+void ValueVector::push_back(std::shared_ptr<Value> val) {
+    if (packed()) {
+        if (auto num = val->asClass<Value_Number>()) {
+            pushNumber(num->value());
+            return;
+        }
+        unpack();
+    }
+
+    if (auto inl = std::get_if<Inline>(&mStorage)) {
+        if (mSize < INLINE_SIZE) {
+            (*inl)[mSize++] = val;
+            return;
+        }
+        spill(val);
+        push_back(val);
+        return;
+    }
+
+    if (auto flat = std::get_if<Flat>(&mStorage)) {
+        if (mSize < SMALL_SIZE) {
+            flat->push_back(val);
+            ++mSize;
+            return;
+        }
+        makePersistent();
+    } else if (mBegin + mSize != std::get<Persistent>(mStorage).size()) {
+        makePersistent();
+    }
+    std::get<Persistent>(mStorage).push_back(val);
+    ++mSize;
+}
+
+void ValueVector::append(const ValueVector& other) {
+    if (packed() && other.packed()) {
+        std::vector<uint64_t> nums;
+        nums.reserve(other.size());
+        other.forEachNumberChunk([&nums] (const uint64_t* p, size_t n) {
+            nums.insert(nums.end(), p, p + n);
+        });
+        for (auto num : nums) pushNumber(num);
+        return;
+    }
+
+    const size_t count = other.size();
+    for (size_t i = 0; i < count; ++i) {
+        push_back(other.at(i));
+    }
+}
+
+ValueVector ValueVector::slice(size_t begin, size_t end) const {
+    if (end > mSize) end = mSize;
+    if (begin > end) begin = end;
+
+    ValueVector vv;
+    if (!std::holds_alternative<Flat>(mStorage) && end - begin > SMALL_SIZE) {
+        vv.mStorage = mStorage;
+        vv.mBegin = mBegin + begin;
+        vv.mSize = end - begin;
+    } else {
+        for (size_t i = begin; i < end; ++i) {
+            vv.push_back(at(i));
+        }
+    }
+    return vv;
+}
+
+std::optional<bool> ValueVector::equalNumbers(const ValueVector& other) const {
+    if (!packed() || !other.packed()) return std::nullopt;
+    if (mSize != other.mSize) return false;
+
+    const auto& rhs = std::get<Packed>(other.mStorage);
+    size_t i = other.mBegin;
+    bool eq = true;
+    forEachNumberChunk([&] (const uint64_t* a, size_t n) {
+        if (eq) {
+            rhs.forEachChunk(i, i + n, [&] (const uint64_t* b, size_t m) {
+                if (eq && !NumericKernels::equal(a, b, m)) eq = false;
+                a += m;
+            });
+        }
+        i += n;
+    });
+    return eq;
+}
+
+std::optional<uint64_t> ValueVector::sumNumbers() const {
+    if (!packed()) return std::nullopt;
+    uint64_t sum = 0;
+    forEachNumberChunk([&sum] (const uint64_t* p, size_t n) {
+        sum += NumericKernels::sum(p, n);
+    });
+    return sum;
+}
+
+std::optional<uint64_t> ValueVector::hashNumbers(uint64_t h) const {
+    if (!packed()) return std::nullopt;
+    forEachNumberChunk([&h] (const uint64_t* p, size_t n) {
+        for (size_t i = 0; i < n; ++i) h = HashMix::combine(h, HashMix::of(p[i]));
+    });
+    return h;
+}
+
+std::optional<ValueVector> ValueVector::mapNumbers(OperationType op, uint64_t lhs) const {
+    if (!packed()) return std::nullopt;
+    if (op == OperationType::DIVIDE || op == OperationType::MODULO) {
+        bool zero = false;
+        forEachNumberChunk([&zero] (const uint64_t* p, size_t n) {
+            if (!zero) zero = NumericKernels::containsZero(p, n);
+        });
+        if (zero) return std::nullopt;
+    }
+
+    ValueVector result;
+    result.mStorage = Packed();
+    uint64_t out[Packed::WIDTH];
+    bool ok = true;
+    forEachNumberChunk([&] (const uint64_t* p, size_t n) {
+        if (!ok) return;
+        ok = NumericKernels::map(op, lhs, p, out, n);
+        for (size_t i = 0; ok && i < n; ++i) result.pushNumber(out[i]);
+    });
+    if (!ok) return std::nullopt;
+    return result;
+}
+
+std::optional<uint64_t> ValueVector::reduceNumbers(OperationType op, uint64_t initial) const {
+    if (!packed()) return std::nullopt;
+    switch (op) {
+        case OperationType::ADD:
+            return initial + sumNumbers().value();
+        case OperationType::SUBTRACT:
+            return initial - sumNumbers().value();
+        case OperationType::MULTIPLY: {
+            uint64_t product = initial;
+            forEachNumberChunk([&product] (const uint64_t* p, size_t n) {
+                product *= NumericKernels::product(p, n);
+            });
+            return product;
+        }
+        default:
+            return std::nullopt;
+    }
+}
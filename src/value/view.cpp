@@ -0,0 +1,234 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/view.h>
+#include <value/number.h>
+#include <value/range.h>
+#include <value/string.h>
+#include <value/table.h>
+#include <value/tuple.h>
+#include <value/typecast_helper.h>
+#include <rtti/rtti.h>
+#include <stream/byte_stream.h>
+#include <stream/serializer.h>
+#include <parser/parser.h>
+
+Value_View::Value_View(Kind k, std::shared_ptr<Value> source, size_t offset, size_t size) : mKind(k), mSource(source), mIterable(nullptr), mTable(nullptr), mOffset(offset), mSize(size) {
+    size_t limit = 0;
+    if (mKind == Kind::SLICE) {
+        if ((mIterable = IterableValue::asIterable(mSource).get())) limit = mIterable->size();
+    } else {
+        if ((mTable = mSource->asClass<Value_Table>())) limit = mTable->size();
+    }
+    if (mOffset > limit) mOffset = limit;
+    if (mSize > limit - mOffset) mSize = limit - mOffset;
+}
+
+std::shared_ptr<Value> Value_View::make(Kind k, std::shared_ptr<Value> source, size_t offset, size_t size) {
+    if (source == nullptr) return nullptr;
+    if (k == Kind::SLICE && IterableValue::asIterable(source) == nullptr) return nullptr;
+    if (k != Kind::SLICE && !source->isOfClass<Value_Table>()) return nullptr;
+    return std::make_shared<Value_View>(k, source, offset, size);
+}
+
+std::shared_ptr<Value> Value_View::slice(std::shared_ptr<Value> val, size_t begin, size_t end) {
+    auto iter = IterableValue::asIterable(val);
+    if (iter == nullptr || begin > end || end > iter->size()) return nullptr;
+
+    if (auto tpl = val->asClass<Value_Tuple>()) {
+        return std::make_shared<Value_Tuple>(tpl->values().slice(begin, end));
+    }
+    if (auto rng = val->asClass<Value_Range>()) {
+        // first + end * step can wrap, or pass the source's last, when slicing to the end
+        auto last = end == iter->size() ? rng->last() : rng->first() + end * rng->step();
+        return Value::range(rng->first() + begin * rng->step(), last, rng->step());
+    }
+    if (auto vw = val->asClass<Value_View>()) {
+        return make(vw->kind(), vw->source(), vw->offset() + begin, end - begin);
+    }
+    return make(Kind::SLICE, val, begin, end - begin);
+}
+
+std::shared_ptr<Value_View> Value_View::keys(std::shared_ptr<Value_Table> tbl) {
+    return std::make_shared<Value_View>(Kind::KEYS, tbl, 0, tbl->size());
+}
+
+std::shared_ptr<Value_View> Value_View::values(std::shared_ptr<Value_Table> tbl) {
+    return std::make_shared<Value_View>(Kind::VALUES, tbl, 0, tbl->size());
+}
+
+Value_View::Kind Value_View::kind() const {
+    return mKind;
+}
+
+std::shared_ptr<Value> Value_View::source() const {
+    return mSource;
+}
+
+size_t Value_View::offset() const {
+    return mOffset;
+}
+
+size_t Value_View::size() const {
+    return mSize;
+}
+
+std::shared_ptr<Value> Value_View::at(size_t i) const {
+    if (i >= mSize) return nullptr;
+    switch (mKind) {
+        case Kind::SLICE: return mIterable->at(mOffset + i);
+        case Kind::KEYS: return mTable->keyAt(mOffset + i);
+        case Kind::VALUES: return mTable->valueAt(mOffset + i);
+    }
+    return nullptr;
+}
+
+bool Value_View::doForEachChunk(size_t begin, size_t end, const ChunkCallback& f) const {
+    if (mKind == Kind::SLICE) return mIterable->forEachChunk(mOffset + begin, mOffset + end, f);
+
+    ChunkBuffer buf(f);
+    const bool keys = (mKind == Kind::KEYS);
+    return mTable->forEachEntry(mOffset + begin, mOffset + end, [&buf, keys] (const std::shared_ptr<Value>& k, const std::shared_ptr<Value>& v) -> bool {
+        return buf.push(keys ? k : v);
+    }) && buf.flush();
+}
+
+std::shared_ptr<Value> Value_View::materialize() const {
+    if (mKind == Kind::SLICE) {
+        if (auto str = mSource->asClass<Value_String>()) {
+            StringStorage ss;
+            for (size_t i = 0; i < mSize; ++i) ss.append(str->storage().at(mOffset + i));
+            return std::make_shared<Value_String>(ss);
+        }
+    }
+
+    return toTuple();
+}
+
+std::shared_ptr<Value_Tuple> Value_View::toTuple() const {
+    ValueVector vv;
+    forEach([&vv] (const std::shared_ptr<Value>& v) -> bool {
+        vv.push_back(v);
+        return true;
+    });
+    return std::make_shared<Value_Tuple>(vv);
+}
+
+std::string Value_View::describe() const {
+    return materialize()->describe();
+}
+
+bool Value_View::equals(std::shared_ptr<Value> v) const {
+    auto vw = runtime_ptr_cast<Value_View>(v);
+    if (vw == nullptr) return false;
+    if (vw == this) return true;
+    if (vw->size() != size()) return false;
+    if (mHash.differs(vw->mHash)) return false;
+
+    size_t i = 0;
+    return forEachChunk([&] (const std::shared_ptr<Value>* a, size_t n) -> bool {
+        bool eq = vw->forEachChunk(i, i + n, [&a] (const std::shared_ptr<Value>* b, size_t m) -> bool {
+            for (size_t j = 0; j < m; ++j) {
+                if (!b[j]->equals(a[j])) return false;
+            }
+            a += m;
+            return true;
+        });
+        i += n;
+        return eq;
+    });
+}
+
+std::shared_ptr<Value> Value_View::fromByteStream(ByteStream* bs) {
+    auto kind = bs->readNumber(1);
+    auto offset = bs->readNumber();
+    auto size = bs->readNumber();
+    if (!kind || !offset || !size || *kind > (uint64_t)Kind::VALUES) return nullptr;
+    auto source = Value::fromByteStream(bs);
+    return make((Kind)*kind, source, *offset, *size);
+}
+
+size_t Value_View::serialize(Serializer* s) {
+    size_t wr = s->writeNumber(MARKER, 1);
+    wr += s->writeNumber((uint8_t)mKind, 1);
+    wr += s->writeNumber(mOffset);
+    wr += s->writeNumber(mSize);
+    wr += mSource->serialize(s);
+    return wr;
+}
+
+// view slice value begin end | view keys table | view values table
+std::shared_ptr<Value> Value_View::fromParser(Parser* p) {
+    auto number = [p] () -> std::optional<uint64_t> {
+        auto tok = p->expectedError(TokenKind::NUMBER);
+        if (!tok) return std::nullopt;
+        const std::string str = tok->value();
+        char* ep = nullptr;
+        uint64_t n = strtoull(str.c_str(), &ep, 0);
+        if (ep && *ep != 0) {
+            p->error("not a valid number");
+            return std::nullopt;
+        }
+        return n;
+    };
+
+    if (p->nextIf(Token(TokenKind::IDENTIFIER, "slice"))) {
+        auto source = Value::fromParser(p);
+        if (source == nullptr) return nullptr;
+        auto begin = number();
+        if (!begin) return nullptr;
+        auto end = number();
+        if (!end) return nullptr;
+        auto vw = slice(source, *begin, *end);
+        if (vw == nullptr) p->error("not a valid slice");
+        return vw;
+    }
+
+    Kind k;
+    if (p->nextIf(Token(TokenKind::IDENTIFIER, "keys"))) k = Kind::KEYS;
+    else if (p->nextIf(Token(TokenKind::IDENTIFIER, "values"))) k = Kind::VALUES;
+    else {
+        p->error("expected 'slice', 'keys' or 'values'");
+        return nullptr;
+    }
+    auto source = Value::fromParser(p);
+    if (source == nullptr) return nullptr;
+    auto tbl = runtime_ptr_cast<Value_Table>(source);
+    if (tbl == nullptr) {
+        p->error("expected a table");
+        return nullptr;
+    }
+    return make(k, source, 0, tbl->size());
+}
+
+size_t Value_View::hash() const {
+    return mHash.get([this] {
+        uint64_t h = HashMix::tagged(ValueType::VIEW, size());
+        forEach([&h] (const std::shared_ptr<Value>& v) -> bool {
+            h = HashMix::combine(h, v->hash());
+            return true;
+        });
+        return h;
+    });
+}
+
+std::shared_ptr<Value> Value_View::clone() const {
+    return sharedClone();
+}
+
+std::shared_ptr<Value> Value_View::doTypecast(ValueType vt) {
+    return TypecastHelper<Value_View>().onType(ValueType::TUPLE, [] (Value_View* self) -> std::shared_ptr<Value> {
+        return self->toTuple();
+    }).doTypecast(this, vt);
+}
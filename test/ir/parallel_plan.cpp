@@ -0,0 +1,204 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ir/parallel_plan.h>
+#include <gtest/gtest.h>
+#include <machine/state.h>
+#include <operation/block.h>
+#include <parser/parser.h>
+#include <value/operation.h>
+#include <value/number.h>
+#include <value/error.h>
+#include <rtti/rtti.h>
+
+namespace {
+    std::shared_ptr<Block> loadBlock(MachineState& ms, const char* prg, const char* name) {
+        Parser p(prg);
+        ms.load(&p);
+        return ms.value_store().retrieve(name)->asClass<Value_Operation>()->block();
+    }
+
+    void runBoth(const char* prg, size_t values) {
+        Parser p1(prg);
+        Parser p2(prg);
+        MachineState seq;
+        MachineState par;
+        par.setParallelExecution(4, 0);
+        ASSERT_EQ(values, seq.load(&p1));
+        ASSERT_EQ(values, par.load(&p2));
+        auto r1 = seq.execute();
+        auto r2 = par.execute();
+        ASSERT_TRUE(r1.has_value());
+        ASSERT_TRUE(r2.has_value());
+        ASSERT_EQ(r1.value(), r2.value());
+        ASSERT_EQ(seq.stack().size(), par.stack().size());
+        ASSERT_EQ(seq.stack().describe(), par.stack().describe());
+    }
+
+    const char* FIB = "value fib block slots $n { loadslot $n dup zero iftrue break "
+                      "dup push number 1 eq iftrue break pop "
+                      "loadslot $n push number 1 swap sub load fib exec "
+                      "loadslot $n push number 2 swap sub load fib exec add }";
+}
+
+TEST(ParallelPlan, StackEffects) {
+    MachineState ms;
+    auto blk = loadBlock(ms, "value f block slots $a, $b { loadslot $a loadslot $b add dup }", "f");
+    auto eff = ParallelPlan::effectOf(blk, ms);
+    ASSERT_TRUE(eff.has_value());
+    ASSERT_EQ(2, eff->consumed);
+    ASSERT_EQ(2, eff->produced);
+
+    auto loop = loadBlock(ms, "value count block { push number 1 add dup push number 10 eq iftrue break loop }", "count");
+    eff = ParallelPlan::effectOf(loop, ms);
+    ASSERT_TRUE(eff.has_value());
+    ASSERT_EQ(1, eff->consumed);
+    ASSERT_EQ(1, eff->produced);
+    ASSERT_GE(eff->cost, ParallelPlan::LOOP_WEIGHT);
+}
+
+TEST(ParallelPlan, RecursiveStackEffect) {
+    MachineState ms;
+    auto blk = loadBlock(ms, FIB, "fib");
+    auto eff = ParallelPlan::effectOf(blk, ms);
+    ASSERT_TRUE(eff.has_value());
+    ASSERT_EQ(1, eff->consumed);
+    ASSERT_EQ(1, eff->produced);
+
+    ms.setParallelExecution(2);
+    auto plan = ParallelPlan::fromBlock(*blk, ms);
+    ASSERT_EQ(1, plan->size());
+    ASSERT_EQ(2, plan->at(0).groups.size());
+}
+
+TEST(ParallelPlan, ImpureOperations) {
+    MachineState ms;
+    auto blk = loadBlock(ms, "value f block { push number 1 store x }", "f");
+    ASSERT_FALSE(ParallelPlan::effectOf(blk, ms).has_value());
+    blk = loadBlock(ms, "value g block { load x exec }", "g");
+    ASSERT_FALSE(ParallelPlan::effectOf(blk, ms).has_value());
+}
+
+TEST(ParallelPlan, Binds) {
+    MachineState ms;
+    auto blk = loadBlock(ms, "value inc bind number 1 operation add "
+                             "value main block { push number 2 load inc exec }", "main");
+    auto eff = ParallelPlan::effectOf(blk, ms);
+    ASSERT_TRUE(eff.has_value());
+    ASSERT_EQ(0, eff->consumed);
+    ASSERT_EQ(1, eff->produced);
+    eff = ParallelPlan::effectOf(ms.value_store().retrieve("inc")->asClass<Value_Operation>()->value(), ms);
+    ASSERT_TRUE(eff.has_value());
+    ASSERT_EQ(1, eff->consumed);
+    ASSERT_EQ(1, eff->produced);
+
+    blk = loadBlock(ms, "value set bind number 1 block { store x } "
+                        "value g block { load set exec }", "g");
+    ASSERT_FALSE(ParallelPlan::effectOf(blk, ms).has_value());
+
+    runBoth("value inc bind number 1 operation add value f block { push number 1 add } "
+            "value main block { push number 2 call f () push number 3 load inc exec push number 4 load inc exec add }", 3);
+    runBoth("value set bind number 7 block { store x } value f block { push number 1 add } "
+            "value main block { push number 2 call f () load set exec push number 3 call f () load x add }", 3);
+}
+
+TEST(ParallelPlan, IndependentCalls) {
+    MachineState ms;
+    ms.setParallelExecution(2, 0);
+    auto blk = loadBlock(ms, "value f block { push number 1 add } "
+                             "value main block { push number 1 call f () push number 2 call f () add push number 5 }", "main");
+    auto plan = ParallelPlan::fromBlock(*blk, ms);
+    ASSERT_EQ(2, plan->size());
+    ASSERT_EQ(0, plan->at(0).begin);
+    ASSERT_EQ(4, plan->at(0).end);
+    ASSERT_EQ(2, plan->at(0).groups.size());
+    ASSERT_EQ(2, plan->at(0).groups[1].begin);
+    ASSERT_EQ(0, plan->at(1).begin);
+    ASSERT_EQ(6, plan->at(1).end);
+    ASSERT_EQ(1, plan->regionAt(0, 6).value());
+    ASSERT_EQ(0, plan->regionAt(0, 5).value());
+    ASSERT_FALSE(plan->regionAt(1, 6).has_value());
+
+    ASSERT_EQ(Operation::Result::SUCCESS, ms.execute().value());
+    ASSERT_EQ(2, ms.stack().size());
+    ASSERT_EQ(5, ms.stack().pop()->asClass<Value_Number>()->value());
+    ASSERT_EQ(5, ms.stack().pop()->asClass<Value_Number>()->value());
+}
+
+TEST(ParallelPlan, Threshold) {
+    MachineState ms;
+    ms.setParallelExecution(2);
+    auto blk = loadBlock(ms, "value f block { push number 1 add } "
+                             "value main block { push number 1 call f () push number 2 call f () add }", "main");
+    ASSERT_EQ(0, ParallelPlan::fromBlock(*blk, ms)->size());
+}
+
+TEST(ParallelPlan, Barriers) {
+    MachineState ms;
+    ms.setParallelExecution(2, 0);
+    auto blk = loadBlock(ms, "value main block { push number 1 store x push number 2 push number 3 }", "main");
+    auto plan = ParallelPlan::fromBlock(*blk, ms);
+    ASSERT_EQ(1, plan->size());
+    ASSERT_EQ(2, plan->at(0).begin);
+    ASSERT_EQ(4, plan->at(0).end);
+}
+
+TEST(ParallelPlan, StalePlan) {
+    MachineState ms;
+    ms.setParallelExecution(2, 0);
+    auto blk = loadBlock(ms, "value f block { push number 1 add } "
+                             "value main block { push number 1 call f () push number 2 call f () add }", "main");
+    auto plan = blk->parallelPlan(ms);
+    ASSERT_TRUE(plan->isCurrent(ms));
+    ms.value_store().store("x", Value::fromNumber(1));
+    ms.value_store().store("main", Value::fromNumber(1), true);
+    ASSERT_TRUE(plan->isCurrent(ms));
+    ASSERT_EQ(plan, blk->parallelPlan(ms));
+    ms.value_store().clear("f");
+    ASSERT_FALSE(plan->isCurrent(ms));
+    ASSERT_EQ(0, blk->parallelPlan(ms)->size());
+}
+
+TEST(ParallelPlan, Fibonacci) {
+    std::string prg(FIB);
+    prg += " value main block { push number 12 load fib exec push number 9 load fib exec }";
+    runBoth(prg.c_str(), 2);
+}
+
+TEST(ParallelPlan, Slots) {
+    runBoth("value f block slots $a { loadslot $a loadslot $a mul } "
+            "value main block slots $x { loadslot $x call f () loadslot $x push number 1 add call f () sub }", 2);
+}
+
+TEST(ParallelPlan, MapAndReduce) {
+    runBoth("value sq block { dup mul } value plus block { add } "
+            "value main block { push tuple (number 1, number 2, number 3) load sq map "
+            "push tuple (number 4, number 5) load sq map push number 0 load plus reduce }", 3);
+}
+
+TEST(ParallelPlan, ErrorInGroup) {
+    runBoth("value f block { push number 1 add } value g block { push boolean true add } "
+            "value main block { push number 1 call f () push number 2 call g () push number 3 call f () add }", 3);
+}
+
+TEST(ParallelPlan, ErrorInFirstGroup) {
+    runBoth("value f block { push number 1 add } value g block { push boolean true add } "
+            "value main block { push number 1 call g () push number 2 call f () push number 3 call f () add }", 3);
+}
+
+TEST(ParallelPlan, Store) {
+    runBoth("value f block { push number 1 add } value g block { push number 2 mul } "
+            "value main block { push number 1 call f () push number 2 call f () "
+            "load g store f push number 3 call f () push number 4 call f () }", 3);
+}
@@ -0,0 +1,134 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ir/pipeline_plan.h>
+#include <gtest/gtest.h>
+#include <machine/state.h>
+#include <operation/block.h>
+#include <parser/parser.h>
+#include <value/operation.h>
+#include <value/number.h>
+#include <value/tuple.h>
+#include <value/range.h>
+#include <value/error.h>
+#include <rtti/rtti.h>
+
+namespace {
+    std::shared_ptr<Block> parseBlock(const char* src) {
+        Parser p(src);
+        auto val = p.parseValuePayload();
+        if (val == nullptr) return nullptr;
+        return val->asClass<Value_Operation>()->block();
+    }
+
+    void runBoth(const char* prg, Operation::Result expected) {
+        Parser p1(prg);
+        Parser p2(prg);
+        MachineState plain;
+        MachineState fused;
+        fused.setPipelineFusion(true);
+        ASSERT_EQ(1, plain.load(&p1));
+        ASSERT_EQ(1, fused.load(&p2));
+        auto r1 = plain.execute();
+        auto r2 = fused.execute();
+        ASSERT_TRUE(r1.has_value());
+        ASSERT_TRUE(r2.has_value());
+        ASSERT_EQ(expected, r1.value());
+        ASSERT_EQ(r1.value(), r2.value());
+        ASSERT_EQ(plain.stack().size(), fused.stack().size());
+        ASSERT_EQ(plain.stack().describe(), fused.stack().describe());
+    }
+}
+
+TEST(PipelinePlan, FindsChains) {
+    auto blk = parseBlock("block { push range 0 10 push block { push number 2 mul } map "
+                          "push block { push number 3 swap mod zero } filter "
+                          "push block { add } push number 0 reduce "
+                          "push block { push number 1 add } map }");
+    ASSERT_NE(nullptr, blk);
+    auto plan = PipelinePlan::fromBlock(*blk);
+    ASSERT_EQ(1, plan->size());
+    ASSERT_FALSE(plan->pipelineAt(0).has_value());
+    ASSERT_EQ(0, plan->pipelineAt(1).value());
+    ASSERT_EQ(1, plan->at(0).begin);
+    ASSERT_EQ(8, plan->at(0).end);
+    ASSERT_EQ(2, plan->at(0).stages.size());
+    ASSERT_EQ(OperationType::MAP, plan->at(0).stages[0].type);
+    ASSERT_EQ(OperationType::FILTER, plan->at(0).stages[1].type);
+    ASSERT_NE(nullptr, plan->at(0).reducer);
+    ASSERT_FALSE(plan->pipelineAt(8).has_value());
+}
+
+TEST(PipelinePlan, SingleStagesAreLeftAlone) {
+    auto blk = parseBlock("block { push block { dup mul } map pop push block { add } push number 0 reduce }");
+    ASSERT_NE(nullptr, blk);
+    ASSERT_EQ(0, PipelinePlan::fromBlock(*blk)->size());
+}
+
+TEST(PipelinePlan, FusedReduce) {
+    auto blk = parseBlock("block { push block { push number 2 mul } map "
+                          "push block { push number 3 swap mod zero } filter "
+                          "push block { add } push number 0 reduce }");
+    ASSERT_NE(nullptr, blk);
+    MachineState ms;
+    ms.setPipelineFusion(true);
+    ms.stack().push(Value::range(0, 10));
+    ASSERT_EQ(Operation::Result::SUCCESS, blk->execute(ms));
+    ASSERT_EQ(1, ms.stack().size());
+    ASSERT_EQ(36, ms.stack().peek()->asClass<Value_Number>()->value());
+}
+
+TEST(PipelinePlan, FusedTuple) {
+    runBoth("value main block { push tuple (number 1, boolean true, number 3, number 4, empty) "
+            "push block { typeof } map "
+            "push block { push type number eq } filter "
+            "push block { size } map }", Operation::Result::SUCCESS);
+}
+
+TEST(PipelinePlan, MatchesUnfused) {
+    runBoth("value main block { push range 1 50 3 "
+            "push block { dup mul } map "
+            "push block { push number 2 swap mod zero } filter "
+            "push block { push number 1 add } map "
+            "push block { add } push number 5 reduce }", Operation::Result::SUCCESS);
+}
+
+TEST(PipelinePlan, PackedTuples) {
+    runBoth("value main block { push tuple (number 1, number 2, number 3, number 4) "
+            "push block { push number 2 mul } map "
+            "push block { push number 1 add } map "
+            "push block { mul } push number 1 reduce }", Operation::Result::SUCCESS);
+}
+
+TEST(PipelinePlan, ErrorStateMatches) {
+    runBoth("value main block { push range 0 10 "
+            "push block { push number 2 mul } map "
+            "push block { push number 3 swap mod } filter }", Operation::Result::ERROR);
+    runBoth("value main block { push range 0 10 "
+            "push block { dup mul } map "
+            "push block { pop push boolean true } filter "
+            "push block { div } push number 1 reduce }", Operation::Result::ERROR);
+}
+
+TEST(PipelinePlan, UnbalancedCallbacksAreNotFused) {
+    runBoth("value main block { push number 7 push number 8 push range 0 2 "
+            "push block { swap pop } map "
+            "push block { push boolean true } filter }", Operation::Result::SUCCESS);
+}
+
+TEST(PipelinePlan, SetsKeepIntermediateSemantics) {
+    runBoth("value main block { push set [number 1, number 2, number 3, number 4] "
+            "push block { push number 2 swap div } map "
+            "push block { add } push number 0 reduce }", Operation::Result::SUCCESS);
+}
@@ -0,0 +1,144 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ir/register_program.h>
+#include <gtest/gtest.h>
+#include <machine/state.h>
+#include <operation/block.h>
+#include <parser/parser.h>
+#include <value/operation.h>
+#include <value/number.h>
+#include <value/boolean.h>
+#include <value/error.h>
+#include <rtti/rtti.h>
+
+namespace {
+    std::shared_ptr<Block> parseBlock(const char* src) {
+        Parser p(src);
+        auto val = p.parseValuePayload();
+        if (val == nullptr) return nullptr;
+        return val->asClass<Value_Operation>()->block();
+    }
+
+    void runBoth(const char* prg, size_t values) {
+        Parser p1(prg);
+        Parser p2(prg);
+        MachineState stk;
+        MachineState reg;
+        reg.setRegisterExecution(true);
+        ASSERT_EQ(values, stk.load(&p1));
+        ASSERT_EQ(values, reg.load(&p2));
+        auto r1 = stk.execute();
+        auto r2 = reg.execute();
+        ASSERT_TRUE(r1.has_value());
+        ASSERT_TRUE(r2.has_value());
+        ASSERT_EQ(r1.value(), r2.value());
+        ASSERT_EQ(stk.stack().size(), reg.stack().size());
+        ASSERT_EQ(stk.stack().describe(), reg.stack().describe());
+    }
+}
+
+TEST(RegisterProgram, ShuffleOpsVanish) {
+    auto blk = parseBlock("block { push number 1 push number 2 swap dup pop pop }");
+    ASSERT_NE(nullptr, blk);
+    auto prg = RegisterProgram::fromBlock(*blk);
+    ASSERT_EQ(1, prg->size());
+    ASSERT_EQ(RegisterProgram::Opcode::FLUSH, prg->at(0).opcode);
+}
+
+TEST(RegisterProgram, ThreeAddressArithmetic) {
+    auto blk = parseBlock("block { push number 3 push number 4 add dup mul }");
+    ASSERT_NE(nullptr, blk);
+    auto prg = RegisterProgram::fromBlock(*blk);
+    ASSERT_EQ(3, prg->size());
+    ASSERT_EQ(RegisterProgram::Opcode::BINARY, prg->at(0).opcode);
+    ASSERT_EQ(OperationType::ADD, prg->at(0).type);
+    ASSERT_EQ(RegisterProgram::Opcode::BINARY, prg->at(1).opcode);
+    ASSERT_EQ(prg->at(0).dst, prg->at(1).a);
+    ASSERT_EQ(prg->at(0).dst, prg->at(1).b);
+    ASSERT_EQ(RegisterProgram::Opcode::FLUSH, prg->at(2).opcode);
+
+    MachineState ms;
+    ms.setRegisterExecution(true);
+    ASSERT_EQ(Operation::Result::SUCCESS, blk->execute(ms));
+    ASSERT_EQ(1, ms.stack().size());
+    ASSERT_EQ(49, ms.stack().peek()->asClass<Value_Number>()->value());
+}
+
+TEST(RegisterProgram, ArgumentsFromStack) {
+    auto blk = parseBlock("block { sub }");
+    ASSERT_NE(nullptr, blk);
+    auto prg = RegisterProgram::fromBlock(*blk);
+    ASSERT_EQ(3, prg->size());
+    ASSERT_EQ(RegisterProgram::Opcode::ARGS, prg->at(0).opcode);
+    ASSERT_EQ(2, prg->at(0).count);
+
+    MachineState ms;
+    ms.setRegisterExecution(true);
+    ms.stack().push(Value::fromNumber(3));
+    ms.stack().push(Value::fromNumber(10));
+    ASSERT_EQ(Operation::Result::SUCCESS, blk->execute(ms));
+    ASSERT_EQ(1, ms.stack().size());
+    ASSERT_EQ(7, ms.stack().peek()->asClass<Value_Number>()->value());
+}
+
+TEST(RegisterProgram, BarrierFlushes) {
+    auto blk = parseBlock("block { push number 1 push number 2 pack push number 3 }");
+    ASSERT_NE(nullptr, blk);
+    auto prg = RegisterProgram::fromBlock(*blk);
+    ASSERT_EQ(3, prg->size());
+    ASSERT_EQ(RegisterProgram::Opcode::FLUSH, prg->at(0).opcode);
+    ASSERT_EQ(RegisterProgram::Opcode::OPERATION, prg->at(1).opcode);
+    ASSERT_EQ(OperationType::PACK, prg->at(1).type);
+    ASSERT_EQ(RegisterProgram::Opcode::FLUSH, prg->at(2).opcode);
+}
+
+TEST(RegisterProgram, DeoptimizeOnTypeMismatch) {
+    runBoth("value main block { push number 5 push number 1 push boolean true add }", 1);
+}
+
+TEST(RegisterProgram, DeoptimizeOnDivisionByZero) {
+    runBoth("value main block { push number 0 push number 5 swap div push number 1 }", 1);
+}
+
+TEST(RegisterProgram, DeoptimizeOnMissingArguments) {
+    runBoth("value main block { push number 5 add }", 1);
+}
+
+TEST(RegisterProgram, DeoptimizedErrorState) {
+    auto blk = parseBlock("block { push number 5 push boolean true add }");
+    ASSERT_NE(nullptr, blk);
+    MachineState ms;
+    ms.setRegisterExecution(true);
+    ASSERT_EQ(Operation::Result::ERROR, blk->execute(ms));
+    ASSERT_EQ(3, ms.stack().size());
+    ASSERT_EQ(ErrorCode::TYPE_MISMATCH, ms.stack().pop()->asClass<Value_Error>()->value());
+    ASSERT_TRUE(ms.stack().pop()->isOfClass<Value_Boolean>());
+    ASSERT_TRUE(ms.stack().pop()->isOfClass<Value_Number>());
+}
+
+TEST(RegisterProgram, Slots) {
+    runBoth("value f block slots $a,$b { loadslot $a loadslot $b sub loadslot $a mul } "
+            "value main block { push number 3 push number 10 load f exec }", 2);
+}
+
+TEST(RegisterProgram, Loops) {
+    runBoth("value count block { push number 1 add dup push number 10 eq iftrue break loop } "
+            "value main block { push number 0 load count exec push number 1 add }", 2);
+}
+
+TEST(RegisterProgram, Recursion) {
+    runBoth("value f block { dup zero iftrue break dup push number 1 swap sub load f exec mul } "
+            "value main block { push number 1 push number 6 load f exec pop }", 2);
+}
@@ -0,0 +1,53 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <machine/worker_pool.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+TEST(WorkerPool, Size) {
+    WorkerPool wp(3);
+    ASSERT_EQ(3, wp.size());
+}
+
+TEST(WorkerPool, RunsEverything) {
+    std::atomic<size_t> count(0);
+    {
+        WorkerPool wp(4);
+        for (size_t i = 0; i < 100; ++i) {
+            wp.submit([&count] () -> void { ++count; });
+        }
+    }
+    ASSERT_EQ(100, count);
+}
+
+TEST(WorkerPool, Concurrent) {
+    WorkerPool wp(2);
+    std::mutex lock;
+    std::condition_variable cv;
+    size_t arrived = 0;
+    auto meet = [&] () -> void {
+        std::unique_lock<std::mutex> lk(lock);
+        ++arrived;
+        cv.notify_all();
+        cv.wait(lk, [&arrived] () -> bool { return arrived == 2; });
+    };
+    wp.submit(meet);
+    wp.submit(meet);
+    std::unique_lock<std::mutex> lk(lock);
+    cv.wait(lk, [&arrived] () -> bool { return arrived == 2; });
+    ASSERT_EQ(2, arrived);
+}
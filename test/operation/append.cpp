@@ -190,4 +190,79 @@ TEST(Append, StringInvalid) {
     ASSERT_EQ(3, ms.stack().size());
     ASSERT_TRUE(ms.stack().peek()->isOfClass<Value_Error>());
     ASSERT_EQ(ErrorCode::TYPE_MISMATCH, ms.stack().peek()->asClass<Value_Error>()->value());
-}
\ No newline at end of file
+}
+TEST(Append, TableSharesStorage) {
+    MachineState s;
+    Append a;
+    auto vtbl = Value::table({});
+    for (size_t i = 0; i < 2000; ++i) {
+        s.stack().push(vtbl);
+        s.stack().push(Value::tuple({Value::fromNumber(i), Value::fromNumber(i + 1)}));
+        ASSERT_EQ(Operation::Result::SUCCESS, a.execute(s));
+        auto next = s.stack().pop();
+        ASSERT_EQ(i + 1, next->asClass<Value_Table>()->size());
+        ASSERT_EQ(i, vtbl->size());
+        vtbl = std::dynamic_pointer_cast<Value_Table>(next);
+    }
+    for (size_t i = 0; i < 2000; ++i) {
+        ASSERT_TRUE(Value::fromNumber(i + 1)->equals(vtbl->retrieve(Value::fromNumber(i))));
+    }
+}
+
+TEST(Append, TupleSharesStorage) {
+    MachineState s;
+    Append a;
+    auto vtpl = Value::tuple({});
+    for (size_t i = 0; i < 2000; ++i) {
+        s.stack().push(vtpl);
+        s.stack().push(Value::fromNumber(i));
+        ASSERT_EQ(Operation::Result::SUCCESS, a.execute(s));
+        auto next = s.stack().pop();
+        ASSERT_EQ(i + 1, next->asClass<Value_Tuple>()->size());
+        ASSERT_EQ(i, vtpl->size());
+        vtpl = std::dynamic_pointer_cast<Value_Tuple>(next);
+    }
+    for (size_t i = 0; i < 2000; ++i) {
+        ASSERT_TRUE(Value::fromNumber(i)->equals(vtpl->at(i)));
+    }
+}
+
+TEST(Append, UniqueContainerInPlace) {
+    MachineState s;
+    Append a;
+    s.stack().push(Value::tuple({Value::fromNumber(1)}));
+    auto before = s.stack().peek().get();
+    s.stack().push(Value::fromNumber(2));
+    ASSERT_EQ(Operation::Result::SUCCESS, a.execute(s));
+    ASSERT_EQ(1, s.stack().size());
+    ASSERT_EQ(before, s.stack().peek().get());
+    ASSERT_EQ(2, s.stack().peek()->asClass<Value_Tuple>()->size());
+}
+
+TEST(Append, SharedContainerCopied) {
+    MachineState s;
+    Append a;
+    auto vtpl = Value::tuple({Value::fromNumber(1)});
+    s.stack().push(vtpl);
+    s.stack().push(vtpl);
+    ASSERT_EQ(Operation::Result::SUCCESS, a.execute(s));
+    ASSERT_EQ(1, s.stack().size());
+    ASSERT_NE(vtpl.get(), s.stack().peek().get());
+    ASSERT_EQ(1, vtpl->size());
+    ASSERT_EQ(2, s.stack().peek()->asClass<Value_Tuple>()->size());
+}
+
+TEST(Append, AccumulateInLoop) {
+    Parser p("value fill block { dup size push number 1000 eq iftrue break dup size append loop } "
+             "value main block { push tuple () load fill exec }");
+    MachineState s;
+    ASSERT_EQ(2, s.load(&p));
+    ASSERT_TRUE(s.execute().has_value());
+    ASSERT_EQ(1, s.stack().size());
+    auto tpl = s.stack().peek()->asClass<Value_Tuple>();
+    ASSERT_NE(nullptr, tpl);
+    ASSERT_EQ(1000, tpl->size());
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(Value::fromNumber(i)->equals(tpl->at(i)));
+    }
+}
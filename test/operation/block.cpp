@@ -253,3 +253,28 @@ TEST(Block, Clone) {
     ASSERT_TRUE(blk->isOfClass<Block>());
     ASSERT_TRUE(blk->equals(blk->clone()));
 }
+
+TEST(Block, CloneCopiesOperations) {
+    Parser p("block { push tuple (number 1, number 2) push block { find } exec nop }");
+    auto vblk = p.parseValuePayload();
+    auto blk = vblk->asClass<Value_Operation>()->block();
+    auto cln = std::dynamic_pointer_cast<Block>(blk->clone());
+    ASSERT_NE(blk.get(), cln.get());
+    ASSERT_TRUE(blk->equals(cln));
+    for (size_t i = 0; i < blk->size(); ++i) {
+        ASSERT_NE(blk->at(i).get(), cln->at(i).get());
+    }
+
+    // operand values are shared, but nested blocks are not, as they carry slots
+    auto tpl = runtime_ptr_cast<Push>(blk->at(0));
+    ASSERT_EQ(tpl->value().get(), runtime_ptr_cast<Push>(cln->at(0))->value().get());
+    auto nested = runtime_ptr_cast<Push>(blk->at(1))->value();
+    auto nestedCln = runtime_ptr_cast<Push>(cln->at(1))->value();
+    ASSERT_NE(nested.get(), nestedCln.get());
+    ASSERT_NE(nested->asClass<Value_Operation>()->block().get(), nestedCln->asClass<Value_Operation>()->block().get());
+    ASSERT_NE(nested->asClass<Value_Operation>()->block()->at(0).get(), nestedCln->asClass<Value_Operation>()->block()->at(0).get());
+
+    cln->add(blk->at(3));
+    ASSERT_EQ(4, blk->size());
+    ASSERT_EQ(5, cln->size());
+}
@@ -20,6 +20,7 @@
 #include <value/error.h>
 #include <value/empty.h>
 #include <value/number.h>
+#include <value/atom.h>
 #include <gtest/gtest.h>
 #include <value/boolean.h>
 
@@ -96,3 +97,28 @@ TEST(Find, TableMissing) {
     ASSERT_EQ(ErrorCode::NOT_FOUND, s.stack().peek()->asClass<Value_Error>()->value());
 }
 
+
+TEST(Find, Records) {
+    auto x = Value::atom("x");
+    auto y = Value::atom("y");
+    MachineState s;
+    Find f;
+    s.stack().push(Value::table( {{x, Value::fromNumber(1)}, {y, Value::fromNumber(2)}} ));
+    s.stack().push(y);
+    ASSERT_EQ(Operation::Result::SUCCESS, f.execute(s));
+    s.stack().push(Value::table( {{y, Value::fromNumber(3)}, {x, Value::fromNumber(4)}} ));
+    s.stack().push(y);
+    ASSERT_EQ(Operation::Result::SUCCESS, f.execute(s));
+    s.stack().push(Value::table( {{x, Value::fromNumber(5)}, {y, Value::fromNumber(6)}} ));
+    s.stack().push(y);
+    ASSERT_EQ(Operation::Result::SUCCESS, f.execute(s));
+    s.stack().push(Value::table( {{x, Value::fromNumber(7)}} ));
+    s.stack().push(y);
+    ASSERT_EQ(Operation::Result::SUCCESS, f.execute(s));
+
+    ASSERT_EQ(4, s.stack().size());
+    ASSERT_EQ(ErrorCode::NOT_FOUND, s.stack().pop()->asClass<Value_Error>()->value());
+    ASSERT_EQ(6, s.stack().pop()->asClass<Value_Number>()->value());
+    ASSERT_EQ(3, s.stack().pop()->asClass<Value_Number>()->value());
+    ASSERT_EQ(2, s.stack().pop()->asClass<Value_Number>()->value());
+}
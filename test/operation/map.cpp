@@ -30,6 +30,8 @@
 #include <value/set.h>
 #include <value/string.h>
 #include <value/empty.h>
+#include <operation/bind.h>
+#include <operation/arith.h>
 
 TEST(Map, ZeroArgs) {
     MachineState s;
@@ -130,3 +132,53 @@ TEST(Map, Set) {
     ASSERT_EQ(3, vset->size());
     ASSERT_TRUE(fset->equals(s.stack().peek()));
 }
+
+namespace {
+    std::shared_ptr<Value> numbers(size_t count, size_t first = 0) {
+        auto tpl = Value::tuple({});
+        for (size_t i = 0; i < count; ++i) {
+            tpl->append(Value::fromNumber(first + i));
+        }
+        return tpl;
+    }
+
+    std::string mapDescribe(std::shared_ptr<Value> tpl, std::shared_ptr<Value> cbk) {
+        MachineState s;
+        Map mp;
+        s.stack().push(tpl);
+        s.stack().push(cbk);
+        mp.execute(s);
+        return s.stack().describe();
+    }
+}
+
+TEST(Map, PackedNumbers) {
+    auto tpl = numbers(100, 1);
+    for (auto op : {"add", "sub", "mul", "div", "mod"}) {
+        auto fast = Parser(std::string("block { push number 1000 ") + op + " }").parseValuePayload();
+        auto slow = Parser(std::string("block { push number 1000 ") + op + " nop }").parseValuePayload();
+        ASSERT_EQ(mapDescribe(tpl, slow), mapDescribe(tpl, fast));
+    }
+
+    auto bind = Value::fromOperation(std::make_shared<PartialBind>(Value::fromNumber(3), std::make_shared<Multiply>()));
+    MachineState s;
+    Map mp;
+    s.stack().push(tpl);
+    s.stack().push(bind);
+    ASSERT_EQ(Operation::Result::SUCCESS, mp.execute(s));
+    auto vres = s.stack().pop();
+    auto res = vres->asClass<Value_Tuple>();
+    ASSERT_NE(nullptr, res);
+    ASSERT_TRUE(res->values().packed());
+    ASSERT_TRUE(numbers(100, 1)->equals(tpl));
+    for (size_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(Value::fromNumber(3 * (i + 1))->equals(res->at(i)));
+    }
+}
+
+TEST(Map, PackedDivisionByZero) {
+    auto tpl = numbers(10);
+    auto fast = Parser("block { push number 10 div }").parseValuePayload();
+    auto slow = Parser("block { push number 10 div nop }").parseValuePayload();
+    ASSERT_EQ(mapDescribe(tpl, slow), mapDescribe(tpl, fast));
+}
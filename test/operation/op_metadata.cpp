@@ -0,0 +1,53 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <operation/op_metadata.h>
+#include <gtest/gtest.h>
+
+static_assert(operationMetadata(OperationType::ADD).consumed == 2);
+static_assert(operationMetadata(OperationType::ADD).produced == 1);
+static_assert(operationMetadata(OperationType::ADD).isPure());
+
+TEST(OperationMetadata, StackEffects) {
+    ASSERT_TRUE(operationMetadata(OperationType::SWAP).hasStackEffect());
+    ASSERT_EQ(2, operationMetadata(OperationType::SWAP).consumed);
+    ASSERT_EQ(2, operationMetadata(OperationType::SWAP).produced);
+    ASSERT_EQ(1, operationMetadata(OperationType::DUP).consumed);
+    ASSERT_EQ(2, operationMetadata(OperationType::DUP).produced);
+    ASSERT_FALSE(operationMetadata(OperationType::PACK).hasStackEffect());
+    ASSERT_FALSE(operationMetadata(OperationType::CALL).hasStackEffect());
+}
+
+TEST(OperationMetadata, Flags) {
+    ASSERT_FALSE(operationMetadata(OperationType::PUSH).canError());
+    ASSERT_TRUE(operationMetadata(OperationType::DIVIDE).canError());
+    ASSERT_TRUE(operationMetadata(OperationType::STORE).touchesStore());
+    ASSERT_TRUE(operationMetadata(OperationType::STORE).hasSideEffects());
+    ASSERT_TRUE(operationMetadata(OperationType::LOAD).touchesStore());
+    ASSERT_FALSE(operationMetadata(OperationType::LOAD).hasSideEffects());
+    ASSERT_TRUE(operationMetadata(OperationType::STORESLOT).touchesSlots());
+    ASSERT_TRUE(operationMetadata(OperationType::LOADNATIVE).touchesNatives());
+    ASSERT_TRUE(operationMetadata(OperationType::BREAK).isControl());
+    ASSERT_TRUE(operationMetadata(OperationType::MAP).calls());
+    ASSERT_FALSE(operationMetadata(OperationType::MAP).isPure());
+}
+
+TEST(OperationMetadata, EveryOperation) {
+    for (auto i = enumToNumber(std::numeric_limits<OperationType>::min()); i <= enumToNumber(std::numeric_limits<OperationType>::max()); ++i) {
+        auto op = static_cast<OperationType>(i);
+        if (operationTypeToString(op) == "unknown" || op == OperationType::NONE) continue;
+        ASSERT_EQ(op, operationMetadata(op).type);
+        ASSERT_NE(0, operationMetadata(op).cost);
+    }
+}
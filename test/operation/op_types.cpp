@@ -51,3 +51,12 @@ TEST(OperationTypes, FromString) {
     ASSERT_NE(std::nullopt, val);
     ASSERT_EQ(OperationType::STORE, val.value());
 }
+
+TEST(OperationTypes, AllTokensFromString) {
+#define OPERATION_TYPE(NAME, CLASS, TOKEN, STRING, NUMBER) \
+    if (std::string(#TOKEN).size()) { ASSERT_EQ(OperationType:: NAME, operationTypeFromString(#TOKEN).value()); }
+#include <operation/op_types.def>
+    ASSERT_EQ(std::nullopt, operationTypeFromString(""));
+    ASSERT_EQ(std::nullopt, operationTypeFromString("adds"));
+    ASSERT_EQ(std::nullopt, operationTypeFromString("ad"));
+}
@@ -106,3 +106,26 @@ TEST(Reduce, Set) {
     ASSERT_EQ(Operation::Result::SUCCESS, r.execute(s));
     ASSERT_TRUE(res_val->equals(s.stack().peek()));
 }
+
+TEST(Reduce, PackedNumbers) {
+    auto tpl = Value::tuple({});
+    for (size_t i = 1; i <= 100; ++i) {
+        tpl->append(Value::fromNumber(i));
+    }
+    for (auto op : {"add", "sub", "mul", "div"}) {
+        auto fast = Parser(std::string("operation ") + op).parseValuePayload();
+        auto slow = Parser(std::string("block { ") + op + " nop }").parseValuePayload();
+        MachineState s1;
+        MachineState s2;
+        Reduce r;
+        s1.stack().push(tpl);
+        s1.stack().push(fast);
+        s1.stack().push(Value::fromNumber(7));
+        s2.stack().push(tpl);
+        s2.stack().push(slow);
+        s2.stack().push(Value::fromNumber(7));
+        ASSERT_EQ(Operation::Result::SUCCESS, r.execute(s1));
+        ASSERT_EQ(Operation::Result::SUCCESS, r.execute(s2));
+        ASSERT_EQ(s2.stack().describe(), s1.stack().describe());
+    }
+}
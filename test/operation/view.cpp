@@ -0,0 +1,83 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <machine/state.h>
+#include <operation/view.h>
+#include <value/value.h>
+#include <value/view.h>
+#include <value/tuple.h>
+#include <value/table.h>
+#include <value/number.h>
+#include <value/string.h>
+#include <value/error.h>
+#include <value/empty.h>
+#include <rtti/rtti.h>
+#include <gtest/gtest.h>
+
+TEST(Slice, MistypedArgs) {
+    MachineState s;
+    Slice op;
+    s.stack().push(Value::fromNumber(1));
+    s.stack().push(Value::fromNumber(0));
+    s.stack().push(Value::empty());
+    ASSERT_EQ(Operation::Result::ERROR, op.execute(s));
+    ASSERT_EQ(ErrorCode::TYPE_MISMATCH, runtime_ptr_cast<Value_Error>(s.stack().pop())->value());
+    ASSERT_EQ(3, s.stack().size());
+}
+
+TEST(Slice, OutOfBounds) {
+    MachineState s;
+    Slice op;
+    s.stack().push(Value::tuple({Value::empty(), Value::empty()}));
+    s.stack().push(Value::fromNumber(1));
+    s.stack().push(Value::fromNumber(3));
+    ASSERT_EQ(Operation::Result::ERROR, op.execute(s));
+    ASSERT_EQ(ErrorCode::OUT_OF_BOUNDS, runtime_ptr_cast<Value_Error>(s.stack().pop())->value());
+    ASSERT_EQ(3, s.stack().size());
+}
+
+TEST(Slice, String) {
+    MachineState s;
+    Slice op;
+    s.stack().push(Value::fromString("hello"));
+    s.stack().push(Value::fromNumber(1));
+    s.stack().push(Value::fromNumber(4));
+    ASSERT_EQ(Operation::Result::SUCCESS, op.execute(s));
+    ASSERT_EQ(1, s.stack().size());
+    auto val = s.stack().pop();
+    auto vw = runtime_ptr_cast<Value_View>(val);
+    ASSERT_NE(nullptr, vw);
+    ASSERT_EQ("ell", vw->describe());
+}
+
+TEST(Keys, NotATable) {
+    MachineState s;
+    Keys op;
+    s.stack().push(Value::tuple({}));
+    ASSERT_EQ(Operation::Result::ERROR, op.execute(s));
+    ASSERT_EQ(ErrorCode::TYPE_MISMATCH, runtime_ptr_cast<Value_Error>(s.stack().pop())->value());
+    ASSERT_EQ(1, s.stack().size());
+}
+
+TEST(Values, Table) {
+    MachineState s;
+    Values op;
+    s.stack().push(Value::table({{Value::fromNumber(1), Value::fromString("one")}}));
+    ASSERT_EQ(Operation::Result::SUCCESS, op.execute(s));
+    auto val = s.stack().pop();
+    auto vw = runtime_ptr_cast<Value_View>(val);
+    ASSERT_NE(nullptr, vw);
+    ASSERT_EQ(Value_View::Kind::VALUES, vw->kind());
+    ASSERT_EQ("one", vw->at(0)->describe());
+}
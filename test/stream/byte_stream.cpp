@@ -179,6 +179,19 @@ TEST(ByteStream, ReadData) {
     ASSERT_FALSE(os.has_value());
 }
 
+TEST(ByteStream, ReadSliceOutlivesStream) {
+    std::vector<uint8_t> i = {0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x2, 'A', 'B', 0x3};
+    auto bs = ByteStream::anonymous((uint8_t*)i.data(), i.size());
+
+    auto sl = bs->readSlice();
+    ASSERT_TRUE(sl.has_value());
+    ASSERT_EQ(2, sl->size);
+    ASSERT_EQ(0x3, bs->next());
+
+    bs.reset();
+    ASSERT_EQ("AB", std::string(sl->data.get(), sl->size));
+}
+
 TEST(ByteStream, ReadBoolean) {
     std::vector<uint8_t> i = {0x0, 0x1, 0x2, 0x1};
     auto bs = ByteStream::anonymous((uint8_t*)i.data(), i.size());
@@ -14,6 +14,9 @@
 
 #include <uniq/uniq.h>
 #include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
 
 TEST(Uniq, NewEmpty) {
     Uniq<int> q;
@@ -46,3 +49,32 @@ TEST(Uniq, FindEquals) {
     ASSERT_EQ(val, q.add(123));
     ASSERT_EQ(1, q.size());
 }
+
+namespace {
+    struct Named {
+        Named(const std::string& n) : name(n) {}
+        std::string name;
+    };
+}
+
+TEST(Uniq, Keyed) {
+    Uniq<Named, std::string> q;
+    auto val = q.add("a");
+    ASSERT_EQ("a", val->name);
+    ASSERT_EQ(val, q.add("a"));
+    ASSERT_EQ(val, q.find("a"));
+    ASSERT_NE(val, q.add("b"));
+    ASSERT_EQ(2, q.size());
+}
+
+TEST(Uniq, ConcurrentAdd) {
+    Uniq<int> q;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&q] {
+            for (int i = 0; i < 1000; ++i) q.add(i);
+        });
+    }
+    for (auto& t : threads) t.join();
+    ASSERT_EQ(1000, q.size());
+}
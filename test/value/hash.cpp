@@ -18,6 +18,10 @@
 #include <gtest/gtest.h>
 #include <rtti/rtti.h>
 #include <value/boolean.h>
+#include <value/set.h>
+#include <value/table.h>
+#include <parser/parser.h>
+#include <set>
 
 TEST(Value, HashConsistent) {
     auto val(Value::fromNumber(123));
@@ -37,3 +41,74 @@ TEST(Value, IdenticalSameHash) {
     ASSERT_TRUE(val1->equals(val2));
     ASSERT_EQ(val1->hash(), val2->hash());
 }
+
+TEST(Value, HashOrderSensitive) {
+    auto t1(Value::tuple({Value::fromNumber(1), Value::fromNumber(2)}));
+    auto t2(Value::tuple({Value::fromNumber(2), Value::fromNumber(1)}));
+    ASSERT_NE(t1->hash(), t2->hash());
+
+    auto t3(Value::tuple({Value::fromNumber(1), Value::fromBoolean(true)}));
+    auto t4(Value::tuple({Value::fromBoolean(true), Value::fromNumber(1)}));
+    ASSERT_NE(t3->hash(), t4->hash());
+}
+
+TEST(Value, HashSpreadsNumbers) {
+    std::set<size_t> buckets;
+    for (uint64_t i = 0; i < 1024; ++i) {
+        buckets.insert(Value::fromNumber(i)->hash() & 0xFF);
+    }
+    ASSERT_GT(buckets.size(), 200);
+}
+
+TEST(Value, HashUnorderedContainers) {
+    auto s1(Value::set({Value::fromNumber(1), Value::fromNumber(2)}));
+    auto s2(Value::set({Value::fromNumber(2), Value::fromNumber(1)}));
+    ASSERT_TRUE(s1->equals(s2));
+    ASSERT_EQ(s1->hash(), s2->hash());
+
+    auto t1(Value::table({{Value::fromNumber(1), Value::fromNumber(2)}, {Value::fromNumber(3), Value::fromNumber(4)}}));
+    auto t2(Value::table({{Value::fromNumber(3), Value::fromNumber(4)}, {Value::fromNumber(1), Value::fromNumber(2)}}));
+    auto t3(Value::table({{Value::fromNumber(1), Value::fromNumber(4)}, {Value::fromNumber(3), Value::fromNumber(2)}}));
+    ASSERT_TRUE(t1->equals(t2));
+    ASSERT_EQ(t1->hash(), t2->hash());
+    ASSERT_NE(t1->hash(), t3->hash());
+}
+
+TEST(Value, HashBlocksStructurally) {
+    Parser p1("block { push number 1 add }");
+    Parser p2("block { push number 1 add }");
+    Parser p3("block { push number 2 add }");
+    Parser p4("block { add push number 1 }");
+    auto b1(p1.parseValuePayload());
+    auto b2(p2.parseValuePayload());
+    auto b3(p3.parseValuePayload());
+    auto b4(p4.parseValuePayload());
+    ASSERT_TRUE(b1->equals(b2));
+    ASSERT_EQ(b1->hash(), b2->hash());
+    ASSERT_NE(b1->hash(), b3->hash());
+    ASSERT_NE(b1->hash(), b4->hash());
+}
+
+TEST(Value, CachedHashFollowsAppend) {
+    auto tpl(Value::tuple({Value::fromNumber(1)}));
+    auto h = tpl->hash();
+    ASSERT_EQ(h, tpl->hash());
+    tpl->append(Value::fromNumber(2));
+    ASSERT_NE(h, tpl->hash());
+    ASSERT_EQ(Value::tuple({Value::fromNumber(1), Value::fromNumber(2)})->hash(), tpl->hash());
+
+    auto set(Value::set({Value::fromNumber(1)}));
+    h = set->hash();
+    set->append(Value::fromNumber(2));
+    ASSERT_NE(h, set->hash());
+    ASSERT_TRUE(set->equals(Value::set({Value::fromNumber(2), Value::fromNumber(1)})));
+}
+
+TEST(Value, CachedHashesRejectEarly) {
+    auto t1(Value::tuple({Value::fromNumber(1), Value::fromBoolean(true)}));
+    auto t2(Value::tuple({Value::fromNumber(2), Value::fromBoolean(true)}));
+    ASSERT_NE(t1->hash(), t2->hash());
+    ASSERT_FALSE(t1->equals(t2));
+    ASSERT_TRUE(t1->equals(t1));
+    ASSERT_TRUE(t1->equals(t1->clone()));
+}
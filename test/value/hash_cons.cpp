@@ -0,0 +1,66 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/hash_cons.h>
+#include <gtest/gtest.h>
+#include <value/value.h>
+#include <value/tuple.h>
+#include <value/string.h>
+#include <value/boolean.h>
+#include <value/operation.h>
+#include <operation/block.h>
+#include <operation/push.h>
+#include <parser/parser.h>
+#include <machine/state.h>
+#include <rtti/rtti.h>
+
+TEST(HashCons, SharesEqualValues) {
+    HashCons hc;
+    auto s1 = hc.intern(Value::fromString("hello"));
+    auto s2 = hc.intern(Value::fromString("hello"));
+    auto s3 = hc.intern(Value::fromString("world"));
+    ASSERT_EQ(s1, s2);
+    ASSERT_NE(s1, s3);
+    ASSERT_EQ(2, hc.size());
+}
+
+TEST(HashCons, SharesChildren) {
+    HashCons hc;
+    auto str = hc.intern(Value::fromString("hello"));
+    std::shared_ptr<Value> bln = Value::fromBoolean(true);
+    auto tpl = hc.intern(Value::tuple({Value::fromString("hello"), bln}));
+    ASSERT_EQ(str, tpl->at(0));
+    ASSERT_EQ(tpl, hc.intern(Value::tuple({Value::fromString("hello"), bln})));
+}
+
+TEST(HashCons, InternsOperands) {
+    Parser p("block { push string \"hello\" push string \"hello\" }");
+    auto val = p.parseValuePayload();
+    ASSERT_NE(nullptr, val);
+    HashCons hc;
+    ASSERT_EQ(val, hc.intern(val));
+
+    auto blk = val->asClass<Value_Operation>()->block();
+    auto p0 = runtime_ptr_cast<Push>(blk->at(0));
+    auto p1 = runtime_ptr_cast<Push>(blk->at(1));
+    ASSERT_EQ(p0->value(), p1->value());
+}
+
+TEST(HashCons, MachineLoad) {
+    Parser p("value a tuple (number 1, string \"x\") value b tuple (number 1, string \"x\")");
+    MachineState ms;
+    ms.setHashConsing(true);
+    ASSERT_EQ(2, ms.load(&p));
+    ASSERT_EQ(ms.value_store().retrieve("a"), ms.value_store().retrieve("b"));
+}
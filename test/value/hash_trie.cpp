@@ -0,0 +1,75 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/hash_trie.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+    struct Entries {
+        std::vector<size_t> keys;
+        HashTrie trie;
+
+        bool add(size_t key, size_t hash) {
+            auto pos = (uint32_t)keys.size();
+            if (!trie.insert(hash, pos, [this, key] (uint32_t p) { return keys[p] == key; })) return false;
+            keys.push_back(key);
+            return true;
+        }
+        uint32_t find(size_t key, size_t hash) const {
+            return trie.find(hash, [this, key] (uint32_t p) { return keys[p] == key; });
+        }
+    };
+}
+
+TEST(HashTrie, FindMissing) {
+    Entries e;
+    ASSERT_EQ(HashTrie::NONE, e.find(1, 1));
+    ASSERT_TRUE(e.add(1, 1));
+    ASSERT_EQ(HashTrie::NONE, e.find(2, 2));
+}
+
+TEST(HashTrie, InsertAndFind) {
+    Entries e;
+    for (size_t i = 0; i < 5000; ++i) {
+        ASSERT_TRUE(e.add(i, i));
+    }
+    for (size_t i = 0; i < 5000; ++i) {
+        ASSERT_FALSE(e.add(i, i));
+        ASSERT_EQ(i, e.find(i, i));
+    }
+    ASSERT_EQ(HashTrie::NONE, e.find(5000, 5000));
+}
+
+TEST(HashTrie, FullCollisions) {
+    Entries e;
+    for (size_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(e.add(i, 42));
+    }
+    ASSERT_FALSE(e.add(5, 42));
+    for (size_t i = 0; i < 10; ++i) {
+        ASSERT_EQ(i, e.find(i, 42));
+    }
+    ASSERT_EQ(HashTrie::NONE, e.find(10, 42));
+}
+
+TEST(HashTrie, CopiesAreIndependent) {
+    Entries e;
+    for (size_t i = 0; i < 100; ++i) e.add(i, i);
+    HashTrie copy = e.trie;
+    e.add(100, 100);
+    ASSERT_EQ(100, e.find(100, 100));
+    ASSERT_EQ(HashTrie::NONE, copy.find(100, [] (uint32_t) { return true; }));
+    ASSERT_EQ(50, copy.find(50, [] (uint32_t p) { return p == 50; }));
+}
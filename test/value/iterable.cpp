@@ -22,6 +22,29 @@
 #include <value/character.h>
 #include <value/boolean.h>
 #include <value/iterator.h>
+#include <value/set.h>
+#include <value/table.h>
+#include <value/range.h>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    void checkChunks(std::shared_ptr<Value> val, size_t begin, size_t end) {
+        auto itr = IterableValue::asIterable(val);
+        ASSERT_NE(nullptr, itr);
+        std::vector<std::shared_ptr<Value>> seen;
+        ASSERT_TRUE(itr->forEachChunk(begin, end, [&seen] (const std::shared_ptr<Value>* p, size_t n) -> bool {
+            EXPECT_GT(n, 0);
+            seen.insert(seen.end(), p, p + n);
+            return true;
+        }));
+        ASSERT_EQ(std::min(end, itr->size()) - begin, seen.size());
+        for (size_t i = 0; i < seen.size(); ++i) {
+            ASSERT_TRUE(itr->at(begin + i)->equals(seen[i]));
+        }
+    }
+}
 
 TEST(Iterable, CorrectCast) {
     auto tpl = Value::tuple({Value::empty(), Value::fromBoolean(false)});
@@ -83,3 +106,102 @@ TEST(Iterable, AsValue) {
     ASSERT_NE(nullptr, itpl->asValue());
     ASSERT_TRUE(tpl->equals(itpl->asValue()));
 }
+
+TEST(Iterable, Chunks) {
+    auto small = Value::tuple({Value::empty(), Value::fromBoolean(false), Value::fromNumber(3)});
+    auto packed = Value::tuple({});
+    auto mixed = Value::tuple({});
+    auto set = Value::set({});
+    auto tbl = Value::table({});
+    for (size_t i = 0; i < 100; ++i) {
+        packed->append(Value::fromNumber(i));
+        if (i % 2) mixed->append(Value::fromNumber(i));
+        else mixed->append(Value::fromString("x"));
+        set->append(Value::fromNumber(i * 7));
+        tbl->append(Value::fromNumber(i), Value::fromBoolean(i % 3 == 0));
+    }
+
+    for (auto val : std::vector<std::shared_ptr<Value>>{small, packed, mixed, set, tbl,
+                                                       Value::fromString("hello w\u00f6rld"),
+                                                       Value::range(5, 500, 3)}) {
+        auto itr = IterableValue::asIterable(val);
+        checkChunks(val, 0, itr->size());
+        checkChunks(val, 1, itr->size() / 2);
+        checkChunks(val, 2, itr->size() + 10);
+    }
+}
+
+TEST(Iterable, ForEachStops) {
+    auto tpl = Value::tuple({});
+    for (size_t i = 0; i < 100; ++i) tpl->append(Value::fromNumber(i));
+
+    size_t visited = 0;
+    ASSERT_FALSE(tpl->forEach([&visited] (const std::shared_ptr<Value>& v) -> bool {
+        ++visited;
+        return v->asClass<Value_Number>()->value() < 40;
+    }));
+    ASSERT_EQ(41, visited);
+
+    visited = 0;
+    ASSERT_TRUE(tpl->forEach([&visited] (const std::shared_ptr<Value>&) -> bool {
+        return ++visited;
+    }));
+    ASSERT_EQ(100, visited);
+}
+
+TEST(Iterable, AsciiCharactersAreShared) {
+    ASSERT_EQ(Value::fromCharacter('a'), Value::fromCharacter('a'));
+    ASSERT_NE(Value::fromCharacter(0x1F600), Value::fromCharacter(0x1F600));
+    ASSERT_TRUE(Value::fromCharacter(0x1F600)->equals(Value::fromCharacter(0x1F600)));
+}
+
+TEST(Iterable, IteratorsCompareByPosition) {
+    auto tpl1 = Value::tuple({Value::empty(), Value::fromBoolean(false)});
+    auto tpl2 = std::dynamic_pointer_cast<Value_Tuple>(tpl1->clone());
+    ASSERT_TRUE(tpl1->equals(tpl2));
+
+    ASSERT_EQ(tpl1->begin(), tpl1->begin());
+    ASSERT_NE(tpl1->begin(), tpl2->begin());
+    ASSERT_NE(tpl1->begin(), tpl1->end());
+    ASSERT_EQ(tpl1->end(), tpl1->begin() + 2);
+    ASSERT_EQ(2, tpl1->end() - tpl1->begin());
+    ASSERT_TRUE(tpl1->begin() < tpl1->end());
+}
+
+TEST(Iterable, RandomAccess) {
+    auto rng = Value::range(0, 100, 2);
+    auto b = rng->begin();
+    auto e = rng->end();
+    ASSERT_EQ(50, std::distance(b, e));
+    ASSERT_EQ(40, b[20]->asClass<Value_Number>()->value());
+    ASSERT_EQ(98, (*(e - 1))->asClass<Value_Number>()->value());
+
+    auto it = b;
+    ASSERT_EQ(b, it++);
+    ASSERT_EQ(b + 1, it);
+    ASSERT_EQ(b + 1, it--);
+    ASSERT_EQ(b, it);
+
+    auto found = std::lower_bound(b, e, 31, [] (const std::shared_ptr<Value>& v, uint64_t n) -> bool {
+        return v->asClass<Value_Number>()->value() < n;
+    });
+    ASSERT_EQ(16, found - b);
+
+    auto sum = std::accumulate(b, e, (uint64_t)0, [] (uint64_t acc, const std::shared_ptr<Value>& v) -> uint64_t {
+        return acc + v->asClass<Value_Number>()->value();
+    });
+    ASSERT_EQ(2450, sum);
+}
+
+TEST(Iterable, StandardAlgorithms) {
+    auto str = Value::fromString("hello world");
+    auto n = std::count_if(str->begin(), str->end(), [] (const std::shared_ptr<Value>& v) -> bool {
+        return v->equals(Value::fromCharacter('o'));
+    });
+    ASSERT_EQ(2, n);
+
+    std::vector<std::shared_ptr<Value>> rev(str->size());
+    std::reverse_copy(str->begin(), str->end(), rev.begin());
+    ASSERT_TRUE(rev.front()->equals(Value::fromCharacter('d')));
+    ASSERT_TRUE(rev.back()->equals(Value::fromCharacter('h')));
+}
@@ -0,0 +1,72 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/persistent_vector.h>
+#include <gtest/gtest.h>
+
+TEST(PersistentVector, StartsEmpty) {
+    PersistentVector<int> pv;
+    ASSERT_TRUE(pv.empty());
+    ASSERT_EQ(0, pv.size());
+}
+
+TEST(PersistentVector, PushBack) {
+    PersistentVector<size_t> pv;
+    for (size_t i = 0; i < 40000; ++i) {
+        pv.push_back(i);
+        ASSERT_EQ(i + 1, pv.size());
+    }
+    for (size_t i = 0; i < 40000; ++i) {
+        ASSERT_EQ(i, pv.at(i));
+    }
+}
+
+TEST(PersistentVector, CopiesAreIndependent) {
+    PersistentVector<size_t> pv;
+    for (size_t i = 0; i < 1056; ++i) pv.push_back(i);
+    auto copy1 = pv;
+    auto copy2 = pv;
+    copy1.push_back(1);
+    copy2.push_back(2);
+    for (size_t i = 0; i < 100; ++i) copy2.push_back(i);
+    ASSERT_EQ(1056, pv.size());
+    ASSERT_EQ(1057, copy1.size());
+    ASSERT_EQ(1157, copy2.size());
+    ASSERT_EQ(1, copy1[1056]);
+    ASSERT_EQ(2, copy2[1056]);
+    for (size_t i = 0; i < 1056; ++i) {
+        ASSERT_EQ(i, pv[i]);
+        ASSERT_EQ(i, copy1[i]);
+        ASSERT_EQ(i, copy2[i]);
+    }
+}
+
+TEST(PersistentVector, Set) {
+    PersistentVector<size_t> pv;
+    for (size_t i = 0; i < 1100; ++i) pv.push_back(i);
+    auto copy = pv;
+    copy.set(0, 5000);
+    copy.set(700, 5700);
+    copy.set(1090, 6090);
+    ASSERT_EQ(1100, copy.size());
+    ASSERT_EQ(5000, copy[0]);
+    ASSERT_EQ(5700, copy[700]);
+    ASSERT_EQ(6090, copy[1090]);
+    for (size_t i = 0; i < 1100; ++i) {
+        ASSERT_EQ(i, pv[i]);
+        if (i != 0 && i != 700 && i != 1090) {
+            ASSERT_EQ(i, copy[i]);
+        }
+    }
+}
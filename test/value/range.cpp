@@ -0,0 +1,99 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/range.h>
+#include <gtest/gtest.h>
+#include <value/value.h>
+#include <value/number.h>
+#include <value/tuple.h>
+#include <value/type.h>
+#include <stream/serializer.h>
+#include <stream/byte_stream.h>
+#include <parser/parser.h>
+#include <rtti/rtti.h>
+#include <machine/state.h>
+
+TEST(Range, Size) {
+    ASSERT_EQ(10, Value::range(0, 10)->size());
+    ASSERT_EQ(5, Value::range(0, 10, 2)->size());
+    ASSERT_EQ(4, Value::range(0, 10, 3)->size());
+    ASSERT_EQ(0, Value::range(10, 10)->size());
+    ASSERT_EQ(0, Value::range(10, 0)->size());
+}
+
+TEST(Range, At) {
+    auto rng = Value::range(3, 20, 4);
+    ASSERT_EQ(3, runtime_ptr_cast<Value_Number>(rng->at(0))->value());
+    ASSERT_EQ(19, runtime_ptr_cast<Value_Number>(rng->at(4))->value());
+    ASSERT_EQ(nullptr, rng->at(5));
+}
+
+TEST(Range, Equals) {
+    ASSERT_TRUE(Value::range(0, 10, 3)->equals(Value::range(0, 11, 3)));
+    ASSERT_EQ(Value::range(0, 10, 3)->hash(), Value::range(0, 11, 3)->hash());
+    ASSERT_TRUE(Value::range(5, 0)->equals(Value::range(7, 7, 2)));
+    ASSERT_TRUE(Value::range(5, 6)->equals(Value::range(5, 6, 9)));
+    ASSERT_FALSE(Value::range(0, 10)->equals(Value::range(0, 10, 2)));
+    ASSERT_FALSE(Value::range(0, 2)->equals(Value::tuple({Value::fromNumber(0), Value::fromNumber(1)})));
+}
+
+TEST(Range, Typecast) {
+    auto tpl = Value::range(1, 4)->typecast(ValueType::TUPLE);
+    ASSERT_NE(nullptr, tpl);
+    ASSERT_TRUE(tpl->equals(Value::tuple({Value::fromNumber(1), Value::fromNumber(2), Value::fromNumber(3)})));
+}
+
+TEST(Range, Serialize) {
+    auto val = Value::range(2, 1000000, 7);
+    Serializer s;
+    val->serialize(&s);
+    ASSERT_EQ(25, s.size());
+    auto bs = ByteStream::anonymous(s.data(), s.size());
+    auto dv = Value::fromByteStream(bs.get());
+    ASSERT_NE(nullptr, dv);
+    ASSERT_TRUE(val->equals(dv));
+}
+
+TEST(Range, Parse) {
+    Parser p1("range 0 10");
+    auto val = p1.parseValuePayload();
+    ASSERT_NE(nullptr, val);
+    ASSERT_EQ(10, val->asClass<Value_Range>()->size());
+
+    Parser p2("range 0 10 5");
+    val = p2.parseValuePayload();
+    ASSERT_NE(nullptr, val);
+    ASSERT_EQ(2, val->asClass<Value_Range>()->size());
+
+    Parser p3("range 0 10 0");
+    ASSERT_EQ(nullptr, p3.parseValuePayload());
+}
+
+TEST(Range, Operations) {
+    Parser p("value main block { push range 0 10 dup size swap "
+             "push block { push number 2 mul } map "
+             "push block { push number 3 swap mod zero } filter "
+             "push block { add } push number 0 reduce "
+             "push range 1 4 unpack push range 5 9 push number 2 at }");
+    MachineState ms;
+    ASSERT_EQ(1, ms.load(&p));
+    ASSERT_EQ(Operation::Result::SUCCESS, ms.execute().value());
+    ASSERT_EQ(6, ms.stack().size());
+    ASSERT_EQ(7, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+    ASSERT_EQ(3, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+    ASSERT_EQ(2, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+    ASSERT_EQ(1, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+    ASSERT_EQ(36, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+    ASSERT_EQ(10, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+}
@@ -137,6 +137,36 @@ TEST(ValueSerialize, String) {
     ASSERT_EQ(runtime_ptr_cast<Value_String>(val)->value(), runtime_ptr_cast<Value_String>(dv)->value());
 }
 
+TEST(ValueSerialize, StringOutlivesStream) {
+    auto val = Value::fromString(U"caf\u00e9 \u20ac");
+    Serializer s;
+    val->serialize(&s);
+    auto bs = ByteStream::anonymous(s.data(), s.size());
+    auto dv = Value::fromByteStream(bs.get());
+    bs.reset();
+    ASSERT_NE(nullptr, dv);
+    auto str = runtime_ptr_cast<Value_String>(dv);
+    ASSERT_EQ(6, str->size());
+    ASSERT_EQ(val->hash(), str->hash());
+    ASSERT_EQ(val->describe(), str->describe());
+    ASSERT_TRUE(str->equals(val));
+    ASSERT_TRUE(str->equals(str->clone()));
+    ASSERT_EQ(U'\u20ac', runtime_ptr_cast<Value_Character>(str->at(5))->value());
+    ASSERT_EQ(StringStorage::Width::UCS2, str->storage().width());
+    str->append(U'!');
+    ASSERT_EQ(U"caf\u00e9 \u20ac!", str->value());
+    ASSERT_EQ(7, str->size());
+}
+
+TEST(ValueSerialize, StringRejectsMalformed) {
+    Serializer s;
+    s.writeNumber(Value_String::MARKER, 1);
+    uint8_t bad[] = {0xC3, 0x28};
+    s.writeData(2, bad);
+    auto bs = ByteStream::anonymous(s.data(), s.size());
+    ASSERT_EQ(nullptr, Value::fromByteStream(bs.get()));
+}
+
 TEST(ValueSerialize, Table) {
     auto val = Value::table({ {Value::fromString("one two three"), Value::fromNumber(123)}, {Value::fromString("four five seven"), Value::fromNumber(457)} });
     Serializer s;
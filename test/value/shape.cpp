@@ -0,0 +1,55 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/shape.h>
+#include <value/value.h>
+#include <value/atom.h>
+#include <gtest/gtest.h>
+
+TEST(Shape, TransitionsAreShared) {
+    auto x = Value::atom("shape_x");
+    auto y = Value::atom("shape_y");
+    auto xy = Shape::empty()->with(x)->with(y);
+    ASSERT_EQ(xy, Shape::empty()->with(x)->with(y));
+    ASSERT_NE(xy, Shape::empty()->with(y)->with(x));
+    ASSERT_NE(xy->id(), Shape::empty()->with(x)->id());
+    ASSERT_EQ(0, Shape::empty()->size());
+    ASSERT_EQ(2, xy->size());
+    ASSERT_EQ(x, xy->keyAt(0));
+    ASSERT_EQ(y, xy->keyAt(1));
+}
+
+TEST(Shape, SlotOf) {
+    auto x = Value::atom("shape_x");
+    auto y = Value::atom("shape_y");
+    auto shape = Shape::empty()->with(y)->with(x);
+    ASSERT_EQ(1, shape->slotOf(x.get()).value());
+    ASSERT_EQ(0, shape->slotOf(y.get()).value());
+    ASSERT_FALSE(shape->slotOf(Value::atom("shape_z").get()).has_value());
+    ASSERT_FALSE(Shape::empty()->slotOf(x.get()).has_value());
+}
+
+TEST(Shape, Cache) {
+    auto x = Value::atom("shape_x");
+    auto y = Value::atom("shape_y");
+    auto xy = Shape::empty()->with(x)->with(y);
+    auto yx = Shape::empty()->with(y)->with(x);
+    ShapeCache cache;
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(1, cache.slotOf(xy, y.get()).value());
+        ASSERT_EQ(0, cache.slotOf(yx, y.get()).value());
+        ASSERT_EQ(1, cache.slotOf(yx, x.get()).value());
+        ASSERT_FALSE(cache.slotOf(yx, Value::atom("shape_z").get()).has_value());
+    }
+}
@@ -0,0 +1,58 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/string_storage.h>
+#include <gtest/gtest.h>
+
+TEST(StringStorage, Empty) {
+    StringStorage ss;
+    ASSERT_EQ(0, ss.size());
+    ASSERT_EQ(StringStorage::Width::LATIN1, ss.width());
+    ASSERT_EQ(U"", ss.u32());
+}
+
+TEST(StringStorage, NarrowestWidth) {
+    ASSERT_EQ(StringStorage::Width::LATIN1, StringStorage(U"café").width());
+    ASSERT_EQ(StringStorage::Width::UCS2, StringStorage(U"café €").width());
+    ASSERT_EQ(StringStorage::Width::UTF32, StringStorage(U"café \U0001F600").width());
+}
+
+TEST(StringStorage, At) {
+    StringStorage ss(U"éa€");
+    ASSERT_EQ(3, ss.size());
+    ASSERT_EQ(U'é', ss.at(0));
+    ASSERT_EQ(U'a', ss.at(1));
+    ASSERT_EQ(U'€', ss.at(2));
+}
+
+TEST(StringStorage, AppendWidens) {
+    StringStorage ss(U"été");
+    ss.append(U'€');
+    ASSERT_EQ(StringStorage::Width::UCS2, ss.width());
+    ss.append(StringStorage(U"\U0001F600"));
+    ASSERT_EQ(StringStorage::Width::UTF32, ss.width());
+    ASSERT_EQ(U"été€\U0001F600", ss.u32());
+    ss.append(ss);
+    ASSERT_EQ(U"été€\U0001F600été€\U0001F600", ss.u32());
+}
+
+TEST(StringStorage, EqualsAndHash) {
+    StringStorage built(U"a");
+    built.append(U'€');
+    StringStorage direct(U"a€");
+    ASSERT_TRUE(built == direct);
+    ASSERT_EQ(built.hash(), direct.hash());
+    ASSERT_TRUE(StringStorage(U"ab") != StringStorage(U"abc"));
+    ASSERT_NE(StringStorage(U"ab").hash(), StringStorage(U"ba").hash());
+}
@@ -0,0 +1,91 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/utf8.h>
+#include <gtest/gtest.h>
+
+namespace {
+    std::optional<std::u32string> decode(const std::string& s) {
+        if (auto ss = Utf8::decode(s.data(), s.size())) return ss->u32();
+        return std::nullopt;
+    }
+}
+
+TEST(Utf8, AsciiIsLatin1) {
+    std::string s(100, 'a');
+    auto ss = Utf8::decode(s.data(), s.size());
+    ASSERT_TRUE(ss.has_value());
+    ASSERT_EQ(StringStorage::Width::LATIN1, ss->width());
+    ASSERT_EQ(100, ss->size());
+    ASSERT_EQ(s, Utf8::encode(*ss));
+}
+
+TEST(Utf8, AsciiPrefix) {
+    std::string s(40, 'a');
+    ASSERT_EQ(40, Utf8::asciiPrefix(s.data(), s.size()));
+    s[33] = '\xC3';
+    ASSERT_EQ(33, Utf8::asciiPrefix(s.data(), s.size()));
+    s[3] = '\x80';
+    ASSERT_EQ(3, Utf8::asciiPrefix(s.data(), s.size()));
+    ASSERT_EQ(0, Utf8::asciiPrefix(s.data(), 0));
+}
+
+TEST(Utf8, MultiByte) {
+    ASSERT_EQ(U"café", decode("caf\xC3\xA9"));
+    ASSERT_EQ(U"€", decode("\xE2\x82\xAC"));
+    ASSERT_EQ(U"\U0001F600", decode("\xF0\x9F\x98\x80"));
+    ASSERT_EQ(U"aé€\U0001F600b", decode("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80" "b"));
+}
+
+TEST(Utf8, NarrowestWidth) {
+    ASSERT_EQ(StringStorage::Width::LATIN1, Utf8::decode("\xC3\xA9", 2)->width());
+    ASSERT_EQ(StringStorage::Width::UCS2, Utf8::decode("\xE2\x82\xAC", 3)->width());
+    ASSERT_EQ(StringStorage::Width::UTF32, Utf8::decode("\xF0\x9F\x98\x80", 4)->width());
+}
+
+TEST(Utf8, Malformed) {
+    ASSERT_FALSE(decode("\x80").has_value());
+    ASSERT_FALSE(decode("\xC3").has_value());
+    ASSERT_FALSE(decode("\xE2\x82").has_value());
+    ASSERT_FALSE(decode("\xC3\x28").has_value());
+    ASSERT_FALSE(decode("\xC0\xAF").has_value());
+    ASSERT_FALSE(decode("\xE0\x80\xAF").has_value());
+    ASSERT_FALSE(decode("\xED\xA0\x80").has_value());
+    ASSERT_FALSE(decode("\xF4\x90\x80\x80").has_value());
+    ASSERT_FALSE(decode("\xFF").has_value());
+}
+
+TEST(Utf8, Lossy) {
+    std::string s("a\xFF" "b\xC3");
+    ASSERT_EQ(U"a�b�", Utf8::decodeLossy(s.data(), s.size()).u32());
+}
+
+TEST(Utf8, Encode) {
+    ASSERT_EQ("caf\xC3\xA9", Utf8::encode(StringStorage(U"café")));
+    ASSERT_EQ("\xE2\x82\xAC", Utf8::encode(StringStorage(U"€")));
+    ASSERT_EQ("\xF0\x9F\x98\x80", Utf8::encode(StringStorage(U"\U0001F600")));
+    ASSERT_EQ("\xEF\xBF\xBD", Utf8::encode(StringStorage(std::u32string(1, 0xD800))));
+}
+
+TEST(Utf8, RoundTripAcrossBlocks) {
+    std::u32string s;
+    for (size_t i = 0; i < 200; ++i) {
+        s.push_back(U'a' + (i % 26));
+        if (i % 37 == 0) s.push_back(U'é');
+        if (i % 53 == 0) s.push_back(U'€');
+        if (i % 71 == 0) s.push_back(U'\U0001F600');
+    }
+    auto bytes = Utf8::encode(StringStorage(s));
+    ASSERT_EQ(s, decode(bytes));
+}
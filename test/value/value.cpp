@@ -95,6 +95,15 @@ TEST(Value, Atom) {
     ASSERT_FALSE(v->equals(Value::fromNumber(1221)));
 }
 
+TEST(Value, AtomsAreInterned) {
+    auto v(Value::atom("interned"));
+    ASSERT_EQ(v, Value::atom("interned"));
+    ASSERT_EQ(v->hash(), Value::atom("interned")->hash());
+    ASSERT_NE(v, Value::atom("other"));
+    ASSERT_EQ(v, v->clone());
+    static_assert(!std::is_constructible_v<Value_Atom, std::string>, "atoms must come from Value::atom");
+}
+
 TEST(Value, TypeMismatch) {
     std::shared_ptr<Value> v = Value::fromNumber(123);
     ASSERT_FALSE(v->isOfClass<Value_Boolean>());
@@ -257,3 +266,41 @@ TEST(Value, Set) {
     ASSERT_TRUE(v->isOfClass<Value_Set>());
     ASSERT_TRUE(v->equals(v->clone()));
 }
+
+TEST(Value, CloneSharesImmutableValues) {
+    auto num = Value::fromNumber(123);
+    ASSERT_EQ(num.get(), num->clone().get());
+    auto atm = Value::atom("foo");
+    ASSERT_EQ(atm.get(), atm->clone().get());
+    auto str = Value::fromString("hello");
+    ASSERT_NE(str.get(), str->clone().get());
+}
+
+TEST(Value, CloneSharesChildren) {
+    auto inner = Value::tuple({Value::fromNumber(1)});
+    auto tpl = Value::tuple({inner, Value::fromString("hi")});
+    auto cln = std::dynamic_pointer_cast<Value_Tuple>(tpl->clone());
+    ASSERT_NE(tpl.get(), cln.get());
+    ASSERT_EQ(inner.get(), cln->at(0).get());
+    ASSERT_EQ(tpl->at(1).get(), cln->at(1).get());
+    cln->append(Value::empty());
+    ASSERT_EQ(2, tpl->size());
+    ASSERT_EQ(3, cln->size());
+
+    auto tbl = Value::table({{Value::fromNumber(1), inner}});
+    auto tcln = std::dynamic_pointer_cast<Value_Table>(tbl->clone());
+    ASSERT_EQ(inner.get(), tcln->valueAt(0).get());
+    tcln->append(Value::fromNumber(2), Value::empty());
+    ASSERT_EQ(1, tbl->size());
+    ASSERT_EQ(2, tcln->size());
+}
+
+TEST(Value, StringHashFollowsAppend) {
+    auto str = Value::fromString("hello");
+    auto h = str->hash();
+    ASSERT_EQ(h, str->hash());
+    str->append(U'!');
+    ASSERT_NE(h, str->hash());
+    ASSERT_EQ(Value::fromString("hello!")->hash(), str->hash());
+    ASSERT_TRUE(Value::fromString("hello!")->equals(str));
+}
@@ -69,3 +69,36 @@ TEST(ValueSet, At) {
     ASSERT_FALSE(vt.at(0)->equals(vt.at(1)));
 }
 
+
+TEST(ValueSet, InsertionOrder) {
+    ValueSet vs;
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(vs.add(Value::fromNumber(7 * i)));
+    }
+    ASSERT_FALSE(vs.add(Value::fromNumber(21)));
+    ASSERT_EQ(1000, vs.size());
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(7 * i, runtime_ptr_cast<Value_Number>(vs.at(i))->value());
+        ASSERT_TRUE(vs.find(Value::fromNumber(7 * i)));
+    }
+    ASSERT_FALSE(vs.find(Value::fromNumber(8)));
+}
+
+TEST(ValueSet, CopiesArePersistent) {
+    ValueSet vs;
+    for (size_t i = 0; i < 1000; ++i) {
+        vs.add(Value::fromNumber(i));
+    }
+    ValueSet copy(vs);
+    ASSERT_TRUE(copy.add(Value::fromNumber(-1)));
+    ASSERT_FALSE(copy.add(Value::fromNumber(999)));
+    ASSERT_EQ(1000, vs.size());
+    ASSERT_EQ(1001, copy.size());
+    ASSERT_FALSE(vs.find(Value::fromNumber(-1)));
+    ASSERT_TRUE(copy.find(Value::fromNumber(-1)));
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(vs.find(Value::fromNumber(i)));
+        ASSERT_TRUE(Value::fromNumber(i)->equals(copy.at(i)));
+    }
+    ASSERT_TRUE(Value::fromNumber(-1)->equals(copy.at(1000)));
+}
@@ -18,6 +18,7 @@
 #include <value/number.h>
 #include <value/empty.h>
 #include <value/tuple.h>
+#include <value/atom.h>
 #include <gtest/gtest.h>
 #include <rtti/rtti.h>
 
@@ -103,3 +104,151 @@ TEST(ValueTable, At) {
     ASSERT_TRUE(vt.at(0)->isOfClass<Value_Tuple>());
     ASSERT_TRUE(vt.at(1)->isOfClass<Value_Tuple>());
 }
+
+TEST(ValueTable, InsertionOrder) {
+    ValueTable vt;
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(vt.add(Value::fromNumber(1000 - i), Value::fromNumber(i)));
+    }
+    ASSERT_FALSE(vt.add(Value::fromNumber(500), Value::empty()));
+    ASSERT_EQ(1000, vt.size());
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(1000 - i, runtime_ptr_cast<Value_Number>(vt.keyAt(i))->value());
+        ASSERT_EQ(i, runtime_ptr_cast<Value_Number>(vt.valueAt(i))->value());
+        ASSERT_EQ(i, runtime_ptr_cast<Value_Number>(vt.find(Value::fromNumber(1000 - i)))->value());
+    }
+    ASSERT_EQ(nullptr, vt.find(Value::fromNumber(0)));
+}
+
+TEST(ValueTable, CopiesArePersistent) {
+    ValueTable vt;
+    for (size_t i = 0; i < 1000; ++i) {
+        vt.add(Value::fromNumber(i), Value::fromNumber(2 * i));
+    }
+    ValueTable copy(vt);
+    ASSERT_TRUE(copy.add(Value::fromNumber(1000), Value::empty()));
+    ASSERT_FALSE(copy.add(Value::fromNumber(500), Value::empty()));
+    ASSERT_EQ(1000, vt.size());
+    ASSERT_EQ(1001, copy.size());
+    ASSERT_EQ(nullptr, vt.find(Value::fromNumber(1000)));
+    ASSERT_TRUE(copy.find(Value::fromNumber(1000))->isOfClass<Value_Empty>());
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(Value::fromNumber(2 * i)->equals(vt.find(Value::fromNumber(i))));
+        ASSERT_TRUE(Value::fromNumber(2 * i)->equals(copy.find(Value::fromNumber(i))));
+        ASSERT_TRUE(Value::fromNumber(i)->equals(copy.keyAt(i)));
+    }
+}
+
+TEST(ValueTable, DenseNumberKeys) {
+    ValueTable vt;
+    for (size_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(vt.add(Value::fromNumber(1000 + 2 * i), Value::fromNumber(i)));
+        ASSERT_TRUE(vt.dense());
+    }
+    for (size_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(vt.add(Value::fromNumber(999 - i), Value::fromNumber(100 + i)));
+    }
+    ASSERT_TRUE(vt.dense());
+    ASSERT_FALSE(vt.add(Value::fromNumber(1002), Value::empty()));
+    ASSERT_EQ(200, vt.size());
+    for (size_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(Value::fromNumber(i)->equals(vt.find(Value::fromNumber(1000 + 2 * i))));
+        ASSERT_TRUE(Value::fromNumber(100 + i)->equals(vt.find(Value::fromNumber(999 - i))));
+        ASSERT_TRUE(Value::fromNumber(1000 + 2 * i)->equals(vt.keyAt(i)));
+        ASSERT_TRUE(Value::fromNumber(999 - i)->equals(vt.keyAt(100 + i)));
+    }
+    ASSERT_EQ(nullptr, vt.find(Value::fromNumber(1001)));
+    ASSERT_EQ(nullptr, vt.find(Value::fromNumber(5000)));
+    ASSERT_EQ(nullptr, vt.find(Value::fromBoolean(true)));
+}
+
+TEST(ValueTable, DenseFallsBackToHashing) {
+    ValueTable vt;
+    for (size_t i = 0; i < 10; ++i) vt.add(Value::fromNumber(i), Value::fromNumber(i));
+    ValueTable far(vt);
+    ValueTable mixed(vt);
+
+    ASSERT_TRUE(far.add(Value::fromNumber(1000000), Value::empty()));
+    ASSERT_FALSE(far.dense());
+    ASSERT_TRUE(mixed.add(Value::fromBoolean(true), Value::empty()));
+    ASSERT_FALSE(mixed.dense());
+    ASSERT_TRUE(vt.dense());
+
+    for (auto tbl : {&far, &mixed}) {
+        ASSERT_EQ(11, tbl->size());
+        ASSERT_FALSE(tbl->add(Value::fromNumber(3), Value::empty()));
+        for (size_t i = 0; i < 10; ++i) {
+            ASSERT_TRUE(Value::fromNumber(i)->equals(tbl->find(Value::fromNumber(i))));
+            ASSERT_TRUE(Value::fromNumber(i)->equals(tbl->keyAt(i)));
+        }
+        ASSERT_TRUE(tbl->valueAt(10)->isOfClass<Value_Empty>());
+    }
+    ASSERT_TRUE(far.find(Value::fromNumber(1000000))->isOfClass<Value_Empty>());
+    ASSERT_TRUE(mixed.find(Value::fromBoolean(true))->isOfClass<Value_Empty>());
+    ASSERT_EQ(10, vt.size());
+}
+
+TEST(ValueTable, DenseFarBelowBase) {
+    ValueTable vt;
+    ASSERT_TRUE(vt.add(Value::fromNumber(UINT64_MAX), Value::fromNumber(1)));
+    ASSERT_TRUE(vt.dense());
+    ASSERT_TRUE(vt.add(Value::fromNumber(0), Value::fromNumber(2)));
+    ASSERT_FALSE(vt.dense());
+    ASSERT_EQ(2, vt.size());
+    ASSERT_TRUE(Value::fromNumber(1)->equals(vt.find(Value::fromNumber(UINT64_MAX))));
+    ASSERT_TRUE(Value::fromNumber(2)->equals(vt.find(Value::fromNumber(0))));
+}
+
+TEST(ValueTable, AtomKeysMakeRecords) {
+    auto x = Value::atom("x");
+    auto y = Value::atom("y");
+    ValueTable p1;
+    ValueTable p2;
+    ASSERT_EQ(nullptr, p1.shape());
+    for (auto vt : {&p1, &p2}) {
+        ASSERT_TRUE(vt->add(x, Value::fromNumber(1)));
+        ASSERT_TRUE(vt->add(y, Value::fromNumber(2)));
+        ASSERT_FALSE(vt->add(x, Value::fromNumber(3)));
+    }
+    ASSERT_NE(nullptr, p1.shape());
+    ASSERT_EQ(p1.shape(), p2.shape());
+    ASSERT_EQ(2, p1.size());
+    ASSERT_EQ(x, p1.keyAt(0));
+    ASSERT_TRUE(Value::fromNumber(2)->equals(p1.valueAt(1)));
+    ASSERT_TRUE(Value::fromNumber(1)->equals(p1.find(x)));
+    ASSERT_EQ(nullptr, p1.find(Value::atom("z")));
+    ASSERT_EQ(nullptr, p1.find(Value::fromNumber(1)));
+
+    ShapeCache cache;
+    ASSERT_TRUE(Value::fromNumber(2)->equals(p1.find(y, cache)));
+    ASSERT_TRUE(Value::fromNumber(2)->equals(p2.find(y, cache)));
+
+    ValueTable copy(p1);
+    ASSERT_TRUE(copy.add(Value::atom("z"), Value::empty()));
+    ASSERT_NE(p1.shape(), copy.shape());
+    ASSERT_EQ(2, p1.size());
+    ASSERT_EQ(nullptr, p1.find(Value::atom("z")));
+}
+
+TEST(ValueTable, RecordFallsBackToHashing) {
+    ValueTable vt;
+    vt.add(Value::atom("x"), Value::fromNumber(1));
+    vt.add(Value::atom("y"), Value::fromNumber(2));
+    ValueTable mixed(vt);
+    ASSERT_TRUE(mixed.add(Value::fromNumber(0), Value::empty()));
+    ASSERT_EQ(nullptr, mixed.shape());
+    ASSERT_NE(nullptr, vt.shape());
+    ASSERT_EQ(3, mixed.size());
+    ASSERT_TRUE(Value::fromNumber(2)->equals(mixed.find(Value::atom("y"))));
+    ASSERT_TRUE(mixed.find(Value::fromNumber(0))->isOfClass<Value_Empty>());
+    ASSERT_TRUE(Value::atom("x")->equals(mixed.keyAt(0)));
+
+    ValueTable wide;
+    for (size_t i = 0; i <= Shape::MAX_SIZE; ++i) {
+        ASSERT_TRUE(wide.add(Value::atom("f" + std::to_string(i)), Value::fromNumber(i)));
+    }
+    ASSERT_EQ(nullptr, wide.shape());
+    for (size_t i = 0; i <= Shape::MAX_SIZE; ++i) {
+        ASSERT_TRUE(Value::fromNumber(i)->equals(wide.find(Value::atom("f" + std::to_string(i)))));
+    }
+}
@@ -43,3 +43,11 @@ TEST(ValueTypes, FromString) {
     ASSERT_NE(std::nullopt, val);
     ASSERT_EQ(ValueType::TABLE, val.value());
 }
+
+TEST(ValueTypes, AllTokensFromString) {
+#define VALUE_TYPE(NAME, TOKEN, STRING, NUMBER, CLASS) \
+    ASSERT_EQ(ValueType:: NAME, valueTypeFromString(#TOKEN).value());
+#include <value/value_types.def>
+    ASSERT_EQ(std::nullopt, valueTypeFromString(""));
+    ASSERT_EQ(std::nullopt, valueTypeFromString("numbers"));
+}
@@ -0,0 +1,172 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/value_vector.h>
+#include <value/value.h>
+#include <value/number.h>
+#include <value/character.h>
+#include <gtest/gtest.h>
+
+namespace {
+    ValueVector numbers(size_t begin, size_t end) {
+        ValueVector vv;
+        for (size_t i = begin; i < end; ++i) {
+            vv.push_back(Value::fromNumber(i));
+        }
+        return vv;
+    }
+
+    ValueVector characters(size_t begin, size_t end) {
+        ValueVector vv;
+        for (size_t i = begin; i < end; ++i) {
+            vv.push_back(Value::fromCharacter(i));
+        }
+        return vv;
+    }
+}
+
+TEST(ValueVector, StartsEmpty) {
+    ValueVector vv;
+    ASSERT_EQ(0, vv.size());
+    ASSERT_EQ(nullptr, vv.at(0));
+}
+
+TEST(ValueVector, SmallVectorsAreInline) {
+    auto vv = characters(0, ValueVector::INLINE_SIZE);
+    ASSERT_TRUE(vv.isInline());
+    vv.push_back(Value::fromCharacter(ValueVector::INLINE_SIZE));
+    ASSERT_FALSE(vv.isInline());
+    ASSERT_FALSE(vv.packed());
+    for (size_t i = 0; i < vv.size(); ++i) {
+        ASSERT_TRUE(Value::fromCharacter(i)->equals(vv.at(i)));
+    }
+
+    auto nums = numbers(0, ValueVector::INLINE_SIZE);
+    ASSERT_TRUE(nums.isInline());
+    ASSERT_FALSE(nums.packed());
+    auto copy = nums;
+    copy.push_back(Value::fromNumber(ValueVector::INLINE_SIZE));
+    ASSERT_TRUE(copy.packed());
+    ASSERT_TRUE(nums.isInline());
+    ASSERT_EQ(ValueVector::INLINE_SIZE, nums.size());
+    for (size_t i = 0; i < copy.size(); ++i) {
+        ASSERT_TRUE(Value::fromNumber(i)->equals(copy.at(i)));
+    }
+
+    auto mixed = numbers(0, 2);
+    mixed.push_back(Value::fromCharacter('a'));
+    ASSERT_TRUE(mixed.isInline());
+    ASSERT_EQ(0, mixed.slice(0, 0).size());
+    ASSERT_TRUE(numbers(0, 100).slice(10, 12).isInline());
+}
+
+TEST(ValueVector, SwitchesToPersistent) {
+    auto vv = characters(0, ValueVector::SMALL_SIZE);
+    ASSERT_FALSE(vv.persistent());
+    vv.push_back(Value::fromCharacter(ValueVector::SMALL_SIZE));
+    ASSERT_TRUE(vv.persistent());
+    ASSERT_EQ(ValueVector::SMALL_SIZE + 1, vv.size());
+    for (size_t i = 0; i < vv.size(); ++i) {
+        ASSERT_TRUE(Value::fromCharacter(i)->equals(vv.at(i)));
+    }
+}
+
+TEST(ValueVector, CopiesAreIndependent) {
+    auto vv = characters(0, 100);
+    auto copy = vv;
+    copy.push_back(Value::fromCharacter(100));
+    ASSERT_EQ(100, vv.size());
+    ASSERT_EQ(101, copy.size());
+    ASSERT_EQ(nullptr, vv.at(100));
+    ASSERT_TRUE(Value::fromCharacter(100)->equals(copy.at(100)));
+}
+
+TEST(ValueVector, Slice) {
+    auto vv = characters(0, 100);
+    auto mid = vv.slice(10, 90);
+    ASSERT_EQ(80, mid.size());
+    ASSERT_TRUE(mid.persistent());
+    ASSERT_TRUE(Value::fromCharacter(10)->equals(mid.at(0)));
+    ASSERT_TRUE(Value::fromCharacter(89)->equals(mid.at(79)));
+    mid.push_back(Value::fromCharacter(1000));
+    ASSERT_EQ(81, mid.size());
+    ASSERT_TRUE(Value::fromCharacter(1000)->equals(mid.at(80)));
+    ASSERT_TRUE(Value::fromCharacter(90)->equals(vv.at(90)));
+
+    auto small = vv.slice(95, 200);
+    ASSERT_FALSE(small.persistent());
+    ASSERT_EQ(5, small.size());
+    ASSERT_EQ(0, vv.slice(50, 10).size());
+}
+
+TEST(ValueVector, Append) {
+    auto vv = characters(0, 40);
+    vv.append(characters(40, 100));
+    ASSERT_EQ(100, vv.size());
+    for (size_t i = 0; i < vv.size(); ++i) {
+        ASSERT_TRUE(Value::fromCharacter(i)->equals(vv.at(i)));
+    }
+}
+
+TEST(ValueVector, PacksNumbers) {
+    auto vv = numbers(0, 100);
+    ASSERT_TRUE(vv.packed());
+    ASSERT_EQ(100, vv.size());
+    for (size_t i = 0; i < vv.size(); ++i) {
+        ASSERT_TRUE(Value::fromNumber(i)->equals(vv.at(i)));
+    }
+    ASSERT_EQ(4950, vv.sumNumbers().value());
+
+    auto mixed = vv;
+    mixed.push_back(Value::fromCharacter('a'));
+    ASSERT_FALSE(mixed.packed());
+    ASSERT_EQ(101, mixed.size());
+    ASSERT_TRUE(Value::fromNumber(99)->equals(mixed.at(99)));
+    ASSERT_TRUE(Value::fromCharacter('a')->equals(mixed.at(100)));
+    ASSERT_TRUE(vv.packed());
+    ASSERT_FALSE(mixed.sumNumbers().has_value());
+}
+
+TEST(ValueVector, EqualNumbers) {
+    auto vv = numbers(0, 100);
+    ASSERT_TRUE(vv.equalNumbers(numbers(0, 100)).value());
+    ASSERT_TRUE(vv.slice(3, 90).equalNumbers(numbers(3, 90)).value());
+    ASSERT_FALSE(vv.equalNumbers(numbers(1, 101)).value());
+    ASSERT_FALSE(vv.equalNumbers(numbers(0, 99)).value());
+    ASSERT_FALSE(vv.equalNumbers(characters(0, 100)).has_value());
+}
+
+TEST(ValueVector, MapNumbers) {
+    auto vv = numbers(1, 101);
+    auto added = vv.mapNumbers(OperationType::ADD, 5).value();
+    auto subbed = vv.mapNumbers(OperationType::SUBTRACT, 1000).value();
+    auto divided = vv.mapNumbers(OperationType::DIVIDE, 1000).value();
+    ASSERT_TRUE(added.packed());
+    ASSERT_EQ(100, added.size());
+    for (size_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(Value::fromNumber(i + 6)->equals(added.at(i)));
+        ASSERT_TRUE(Value::fromNumber(999 - i)->equals(subbed.at(i)));
+        ASSERT_TRUE(Value::fromNumber(1000 / (i + 1))->equals(divided.at(i)));
+    }
+    ASSERT_FALSE(numbers(0, 10).mapNumbers(OperationType::MODULO, 7).has_value());
+    ASSERT_FALSE(vv.mapNumbers(OperationType::EQUALS, 7).has_value());
+}
+
+TEST(ValueVector, ReduceNumbers) {
+    auto vv = numbers(1, 11);
+    ASSERT_EQ(60, vv.reduceNumbers(OperationType::ADD, 5).value());
+    ASSERT_EQ(45, vv.reduceNumbers(OperationType::SUBTRACT, 100).value());
+    ASSERT_EQ(3628800, vv.reduceNumbers(OperationType::MULTIPLY, 1).value());
+    ASSERT_FALSE(vv.reduceNumbers(OperationType::DIVIDE, 1).has_value());
+}
@@ -0,0 +1,168 @@
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <value/view.h>
+#include <gtest/gtest.h>
+#include <value/value.h>
+#include <value/number.h>
+#include <value/boolean.h>
+#include <value/character.h>
+#include <value/string.h>
+#include <value/table.h>
+#include <value/tuple.h>
+#include <value/range.h>
+#include <value/type.h>
+#include <stream/serializer.h>
+#include <stream/byte_stream.h>
+#include <parser/parser.h>
+#include <rtti/rtti.h>
+#include <machine/state.h>
+
+namespace {
+    std::shared_ptr<Value_Table> makeTable(size_t n) {
+        auto tbl = Value::table({});
+        for (size_t i = 0; i < n; ++i) tbl->append(Value::fromNumber(i), Value::fromNumber(i * i));
+        return tbl;
+    }
+}
+
+TEST(View, SliceTuple) {
+    auto tpl = Value::tuple({});
+    for (size_t i = 0; i < 100; ++i) tpl->append(Value::fromNumber(i));
+    auto sl = Value_View::slice(tpl, 10, 20);
+    ASSERT_NE(nullptr, sl);
+    ASSERT_TRUE(sl->isOfClass<Value_Tuple>());
+    ASSERT_EQ(10, sl->asClass<Value_Tuple>()->size());
+    ASSERT_EQ(15, sl->asClass<Value_Tuple>()->at(5)->asClass<Value_Number>()->value());
+
+    ASSERT_EQ(nullptr, Value_View::slice(tpl, 20, 10));
+    ASSERT_EQ(nullptr, Value_View::slice(tpl, 0, 101));
+    ASSERT_EQ(nullptr, Value_View::slice(Value::fromNumber(3), 0, 0));
+}
+
+TEST(View, SliceRange) {
+    auto sl = Value_View::slice(Value::range(3, 100, 4), 2, 5);
+    ASSERT_NE(nullptr, sl);
+    ASSERT_TRUE(sl->equals(Value::range(11, 23, 4)));
+}
+
+TEST(View, SliceRangeToEnd) {
+    auto sl = Value_View::slice(Value::range(0, 10, 3), 1, 4);
+    ASSERT_EQ("range(3, 10, 3)", sl->describe());
+
+    auto big = Value::range(1ull << 63, UINT64_MAX, 1ull << 62);
+    ASSERT_EQ(2, big->size());
+    auto all = Value_View::slice(big, 0, 2);
+    ASSERT_EQ(2, all->asClass<Value_Range>()->size());
+    ASSERT_TRUE(all->equals(big));
+    ASSERT_TRUE(Value::fromNumber(UINT64_MAX - (1ull << 62) + 1)->equals(all->asClass<Value_Range>()->at(1)));
+}
+
+TEST(View, SliceString) {
+    auto str = Value::fromString("hello world");
+    auto sl = Value_View::slice(str, 6, 11);
+    ASSERT_NE(nullptr, sl);
+    auto vw = sl->asClass<Value_View>();
+    ASSERT_NE(nullptr, vw);
+    ASSERT_EQ(str, vw->source());
+    ASSERT_EQ(5, vw->size());
+    ASSERT_TRUE(vw->at(0)->equals(Value::fromCharacter('w')));
+    ASSERT_EQ("world", vw->describe());
+    ASSERT_TRUE(vw->materialize()->equals(Value::fromString("world")));
+    ASSERT_TRUE(sl->typecast(ValueType::STRING)->equals(Value::fromString("world")));
+
+    auto innerVal = Value_View::slice(sl, 1, 3);
+    auto inner = innerVal->asClass<Value_View>();
+    ASSERT_NE(nullptr, inner);
+    ASSERT_EQ(str, inner->source());
+    ASSERT_EQ(7, inner->offset());
+    ASSERT_EQ("or", inner->describe());
+}
+
+TEST(View, KeysAndValues) {
+    auto tbl = makeTable(50);
+    auto keys = Value_View::keys(tbl);
+    auto values = Value_View::values(tbl);
+    ASSERT_EQ(50, keys->size());
+    ASSERT_EQ(50, values->size());
+    ASSERT_EQ(7, keys->at(7)->asClass<Value_Number>()->value());
+    ASSERT_EQ(49, values->at(7)->asClass<Value_Number>()->value());
+
+    uint64_t sum = 0;
+    ASSERT_TRUE(values->forEach([&sum] (const std::shared_ptr<Value>& v) -> bool {
+        sum += v->asClass<Value_Number>()->value();
+        return true;
+    }));
+    ASSERT_EQ(40425, sum);
+
+    auto sl = Value_View::slice(keys, 40, 42);
+    ASSERT_NE(nullptr, sl);
+    ASSERT_TRUE(sl->typecast(ValueType::TUPLE)->equals(Value::tuple({Value::fromNumber(40), Value::fromNumber(41)})));
+}
+
+TEST(View, Equals) {
+    auto str = Value::fromString("abcabc");
+    auto a = Value_View::slice(str, 0, 3);
+    auto b = Value_View::slice(str, 3, 6);
+    auto c = Value_View::slice(str, 1, 4);
+    ASSERT_TRUE(a->equals(b));
+    ASSERT_EQ(a->hash(), b->hash());
+    ASSERT_FALSE(a->equals(c));
+    ASSERT_FALSE(a->equals(Value::fromString("abc")));
+}
+
+TEST(View, Serialize) {
+    auto val = Value_View::values(makeTable(10));
+    Serializer s;
+    val->serialize(&s);
+    auto bs = ByteStream::anonymous(s.data(), s.size());
+    auto dv = Value::fromByteStream(bs.get());
+    ASSERT_NE(nullptr, dv);
+    ASSERT_TRUE(dv->isOfClass<Value_View>());
+    ASSERT_TRUE(val->equals(dv));
+}
+
+TEST(View, Parse) {
+    Parser p1("view slice string \"hello\" 1 3");
+    auto val = p1.parseValuePayload();
+    ASSERT_NE(nullptr, val);
+    ASSERT_EQ("el", val->describe());
+
+    Parser p2("view keys table [number 1 -> boolean true, number 2 -> boolean false]");
+    val = p2.parseValuePayload();
+    ASSERT_NE(nullptr, val);
+    ASSERT_EQ(2, val->asClass<Value_View>()->size());
+
+    Parser p3("view values number 3");
+    ASSERT_EQ(nullptr, p3.parseValuePayload());
+
+    Parser p4("view slice string \"hello\" 3 9");
+    ASSERT_EQ(nullptr, p4.parseValuePayload());
+}
+
+TEST(View, Operations) {
+    Parser p("value main block { push string \"hello world\" push number 0 push number 5 slice dup size swap "
+             "push table [number 1 -> number 10, number 2 -> number 20] dup keys swap values "
+             "push block { add } push number 0 reduce swap "
+             "push block { push number 1 add } map unpack }");
+    MachineState ms;
+    ASSERT_EQ(1, ms.load(&p));
+    ASSERT_EQ(Operation::Result::SUCCESS, ms.execute().value());
+    ASSERT_EQ(5, ms.stack().size());
+    ASSERT_EQ(3, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+    ASSERT_EQ(2, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+    ASSERT_EQ(30, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+    ASSERT_EQ("hello", ms.stack().pop()->describe());
+    ASSERT_EQ(5, runtime_ptr_cast<Value_Number>(ms.stack().pop())->value());
+}